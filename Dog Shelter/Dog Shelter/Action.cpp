@@ -1,10 +1,205 @@
+#include <cstring>
 #include "Action.h"
 
+// the tags of the encoded actions
+enum class ActionType : char
+{
+	Add = 'a',
+	Remove = 'r',
+	Update = 'u',
+	Adopt = 'o',
+	Batch = 'b'
+};
+
+static void putInt(std::string& buffer, const int32_t& value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void putId(std::string& buffer, const uint64_t& value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void putString(std::string& buffer, const std::string& value)
+{
+	putInt(buffer, static_cast<int32_t>(value.size()));
+	buffer.append(value);
+}
+
+static void putDog(std::string& buffer, const Dog& dog)
+{
+	putString(buffer, dog.getName());
+	putString(buffer, dog.getBreed());
+	putInt(buffer, dog.getAge());
+	putString(buffer, dog.getPhotohraph());
+	putId(buffer, dog.getId());
+}
+
+static bool getInt(std::string_view& data, int32_t& value)
+{
+	if (data.size() < sizeof(value))
+		return false;
+
+	std::memcpy(&value, data.data(), sizeof(value));
+	data.remove_prefix(sizeof(value));
+	return true;
+}
+
+static bool getId(std::string_view& data, uint64_t& value)
+{
+	if (data.size() < sizeof(value))
+		return false;
+
+	std::memcpy(&value, data.data(), sizeof(value));
+	data.remove_prefix(sizeof(value));
+	return true;
+}
+
+static bool getString(std::string_view& data, std::string& value)
+{
+	int32_t length = 0;
+	if (!getInt(data, length) || length < 0 || static_cast<size_t>(length) > data.size())
+		return false;
+
+	value.assign(data.data(), static_cast<size_t>(length));
+	data.remove_prefix(static_cast<size_t>(length));
+	return true;
+}
+
+static bool getDog(std::string_view& data, Dog& dog)
+{
+	std::string name, breed, photograph;
+	int32_t age = 0;
+	uint64_t id = 0;
+	if (!getString(data, name) || !getString(data, breed) || !getInt(data, age) || !getString(data, photograph) || !getId(data, id))
+		return false;
+
+	dog = Dog{ name, breed, age, photograph };
+	dog.setId(id);
+	return true;
+}
+
+// the memory of a dog, with the characters of its strings
+static size_t dogSize(const Dog& dog)
+{
+	return sizeof(Dog) + dog.getName().size() + dog.getBreed().size() + dog.getPhotohraph().size();
+}
+
+/// <summary>
+/// Applies the changed fields kept by an update to a dog
+/// </summary>
+/// <param name="data">the encoded fields, they are consumed from it</param>
+/// <param name="changed">the fields that changed</param>
+/// <param name="dog">the dog after the update, it becomes the dog before</param>
+/// <returns>true if every field could be read, false, otherwise</returns>
+static bool applyDelta(std::string_view& data, const int32_t& changed, Dog& dog)
+{
+	std::string field;
+	int32_t age = 0;
+
+	if (changed & UPDATE_NAME)
+	{
+		if (!getString(data, field)) return false;
+		dog.setName(field);
+	}
+	if (changed & UPDATE_BREED)
+	{
+		if (!getString(data, field)) return false;
+		dog.setBreed(field);
+	}
+	if (changed & UPDATE_AGE)
+	{
+		if (!getInt(data, age)) return false;
+		dog.setAge(age);
+	}
+	if (changed & UPDATE_PHOTOGRAPH)
+	{
+		if (!getString(data, field)) return false;
+		dog.setPhotograph(field);
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Decodes an action encoded by Action::encode
+/// </summary>
+/// <param name="data">the encoded action, the action is consumed from it</param>
+/// <param name="context">what the action works on</param>
+/// <returns>the action, nullptr if the data is malformed</returns>
+std::unique_ptr<Action> Action::decode(std::string_view& data, const ActionContext& context)
+{
+	if (data.empty())
+		return nullptr;
+
+	ActionType type = static_cast<ActionType>(data.front());
+	data.remove_prefix(1);
+
+	Dog dog{};
+	int32_t index = 0;
+
+	switch (type)
+	{
+	case ActionType::Add:
+		if (!getDog(data, dog) || !getInt(data, index))
+			return nullptr;
+		return std::make_unique<ActionAdd>(dog, context.repo, index);
+
+	case ActionType::Remove:
+		if (!getDog(data, dog) || !getInt(data, index))
+			return nullptr;
+		return std::make_unique<ActionRemove>(dog, context.repo, index);
+
+	case ActionType::Update:
+	{
+		int32_t changed = 0;
+		if (!getDog(data, dog) || !getInt(data, index) || !getInt(data, changed))
+			return nullptr;
+
+		Dog oldDog = dog;
+		if (!applyDelta(data, changed, oldDog))
+			return nullptr;
+		return std::make_unique<ActionUpdate>(oldDog, dog, context.repo, index);
+	}
+
+	case ActionType::Adopt:
+	{
+		int32_t dogsToShowIndex = 0, adoptionListIndex = 0;
+		if (context.dogsToShow == nullptr || context.adoptionList == nullptr)
+			return nullptr;
+		if (!getDog(data, dog) || !getInt(data, index) || !getInt(data, dogsToShowIndex) || !getInt(data, adoptionListIndex))
+			return nullptr;
+		return std::make_unique<ActionAdopt>(dog, context.repo, index, *context.dogsToShow, dogsToShowIndex,
+			context.adoptionList, adoptionListIndex);
+	}
+
+	case ActionType::Batch:
+	{
+		int32_t count = 0;
+		if (!getInt(data, count) || count < 0)
+			return nullptr;
+
+		std::vector<std::unique_ptr<Action>> actions;
+		for (int32_t i = 0; i < count; i++)
+		{
+			std::unique_ptr<Action> action = decode(data, context);
+			if (action == nullptr)
+				return nullptr;
+			actions.push_back(std::move(action));
+		}
+		return std::make_unique<ActionBatch>(std::move(actions), context.repo);
+	}
+	}
+
+	return nullptr;
+}
+
 ActionAdd::ActionAdd(const Dog& dog, Repository& repo, const int& index) : addedDog{ dog }, repo{ repo }, index{ index } { }
 
 void ActionAdd::executeUndo()
 {
-	repo.remove(addedDog);
+	repo.removeAt(index, addedDog);
 }
 
 void ActionAdd::executeRedo()
@@ -12,6 +207,18 @@ void ActionAdd::executeRedo()
 	repo.add(addedDog, index);
 }
 
+size_t ActionAdd::size() const
+{
+	return sizeof(*this) + dogSize(addedDog) - sizeof(Dog);
+}
+
+void ActionAdd::encode(std::string& buffer) const
+{
+	buffer.push_back(static_cast<char>(ActionType::Add));
+	putDog(buffer, addedDog);
+	putInt(buffer, index);
+}
+
 ActionRemove::ActionRemove(const Dog& dog, Repository& repo, const int& index) : deletedDog{ dog }, repo{ repo }, index{ index } { }
 
 void ActionRemove::executeUndo()
@@ -21,23 +228,84 @@ void ActionRemove::executeUndo()
 
 void ActionRemove::executeRedo()
 {
-	repo.remove(deletedDog);
+	repo.removeAt(index, deletedDog);
 }
 
-ActionUpdate::ActionUpdate(const Dog& oldDog, const Dog& newDog, Repository& repo) : oldDog{ oldDog }, newDog{ newDog }, repo{ repo } { }
+size_t ActionRemove::size() const
+{
+	return sizeof(*this) + dogSize(deletedDog) - sizeof(Dog);
+}
+
+void ActionRemove::encode(std::string& buffer) const
+{
+	buffer.push_back(static_cast<char>(ActionType::Remove));
+	putDog(buffer, deletedDog);
+	putInt(buffer, index);
+}
+
+ActionUpdate::ActionUpdate(const Dog& oldDog, const Dog& newDog, Repository& repo, const int& index) : newDog{ newDog }, repo{ repo }, index{ index }
+{
+	// the fields left as they were are taken from the new dog
+	if (oldDog.getName() != newDog.getName())
+	{
+		this->changed |= UPDATE_NAME;
+		putString(this->delta, oldDog.getName());
+	}
+	if (oldDog.getBreed() != newDog.getBreed())
+	{
+		this->changed |= UPDATE_BREED;
+		putString(this->delta, oldDog.getBreed());
+	}
+	if (oldDog.getAge() != newDog.getAge())
+	{
+		this->changed |= UPDATE_AGE;
+		putInt(this->delta, oldDog.getAge());
+	}
+	if (oldDog.getPhotohraph() != newDog.getPhotohraph())
+	{
+		this->changed |= UPDATE_PHOTOGRAPH;
+		putString(this->delta, oldDog.getPhotohraph());
+	}
+}
+
+/// <summary>
+/// Rebuilds the dog as it was before the update
+/// </summary>
+/// <returns>the old dog</returns>
+Dog ActionUpdate::getOldDog() const
+{
+	Dog dog = this->newDog;
+	std::string_view data{ this->delta };
+	applyDelta(data, this->changed, dog);
+	return dog;
+}
 
 void ActionUpdate::executeUndo()
 {
-	repo.update(newDog, oldDog);
+	repo.updateAt(index, newDog, getOldDog());
 }
 
 void ActionUpdate::executeRedo()
 {
-	repo.update(oldDog, newDog);
+	repo.updateAt(index, getOldDog(), newDog);
+}
+
+size_t ActionUpdate::size() const
+{
+	return sizeof(*this) + dogSize(newDog) - sizeof(Dog) + delta.size();
+}
+
+void ActionUpdate::encode(std::string& buffer) const
+{
+	buffer.push_back(static_cast<char>(ActionType::Update));
+	putDog(buffer, newDog);
+	putInt(buffer, index);
+	putInt(buffer, changed);
+	buffer.append(delta);
 }
 
 ActionAdopt::ActionAdopt(const Dog& dog, Repository& repo, const int& repoIndex,
-	Repository& dogsToShow, const int& dogsToShowIndex,
+	DogView& dogsToShow, const int& dogsToShowIndex,
 	AdoptionList* adoptionList, const int& adoptionListIndex) : adoptedDog{ dog }, repo{ repo }, repoIndex{ repoIndex },
 																dogsToShow{ dogsToShow }, dogsToShowIndex{ dogsToShowIndex },
 																adoptionList{ adoptionList }, adoptionListIndex{ adoptionListIndex } { }
@@ -47,13 +315,67 @@ void ActionAdopt::executeUndo()
 	adoptionList->remove(adoptedDog);
 	repo.add(adoptedDog, repoIndex);
 
-	dogsToShow.add(adoptedDog, dogsToShowIndex);
+	dogsToShow.insert(adoptedDog, dogsToShowIndex);
 }
 
 void ActionAdopt::executeRedo()
 {
-	dogsToShow.remove(adoptedDog);
+	dogsToShow.removeAt(dogsToShowIndex, adoptedDog);
 
-	repo.remove(adoptedDog);
+	repo.removeAt(repoIndex, adoptedDog);
 	adoptionList->add(adoptedDog, adoptionListIndex);
 }
+
+size_t ActionAdopt::size() const
+{
+	return sizeof(*this) + dogSize(adoptedDog) - sizeof(Dog);
+}
+
+void ActionAdopt::encode(std::string& buffer) const
+{
+	buffer.push_back(static_cast<char>(ActionType::Adopt));
+	putDog(buffer, adoptedDog);
+	putInt(buffer, repoIndex);
+	putInt(buffer, dogsToShowIndex);
+	putInt(buffer, adoptionListIndex);
+}
+
+ActionBatch::ActionBatch(std::vector<std::unique_ptr<Action>> actions, Repository& repo) : actions{ std::move(actions) }, repo{ repo } { }
+
+void ActionBatch::executeUndo()
+{
+	RepositoryBatch batch{ repo };
+
+	for (auto it = actions.rbegin(); it != actions.rend(); ++it)
+		(*it)->executeUndo();
+
+	batch.end();
+}
+
+void ActionBatch::executeRedo()
+{
+	RepositoryBatch batch{ repo };
+
+	for (auto& action : actions)
+		action->executeRedo();
+
+	batch.end();
+}
+
+size_t ActionBatch::size() const
+{
+	size_t size = sizeof(*this) + actions.capacity() * sizeof(std::unique_ptr<Action>);
+	for (const auto& action : actions)
+		size += action->size();
+
+	return size;
+}
+
+void ActionBatch::encode(std::string& buffer) const
+{
+	buffer.push_back(static_cast<char>(ActionType::Batch));
+	putInt(buffer, static_cast<int32_t>(actions.size()));
+
+	for (const auto& action : actions)
+		action->encode(buffer);
+}
@@ -1,15 +1,38 @@
 #pragma once
 
+#include <vector>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <cstdint>
 #include "Dog.h"
 #include "Repository.h"
+#include "DogView.h"
 #include "AdoptionList.h"
 
+// what a decoded action works on, dogsToShow is only
+// set for the history of the adoption page
+struct ActionContext
+{
+	Repository& repo;
+	DogView* dogsToShow;
+	AdoptionList* adoptionList;
+};
+
+// the indices kept by the actions are where their dogs were, they let
+// the replay skip the lookups as long as nothing moved the dogs since
 class Action
 {
 public:
 	virtual void executeUndo() = 0;
 	virtual void executeRedo() = 0;
 
+	// the memory the action takes, counted against the history budget
+	virtual size_t size() const = 0;
+	// appends the compact form of the action, see decode
+	virtual void encode(std::string& buffer) const = 0;
+	static std::unique_ptr<Action> decode(std::string_view& data, const ActionContext& context);
+
 	virtual ~Action() = default;
 };
 
@@ -25,6 +48,9 @@ public:
 
 	void executeUndo() override;
 	void executeRedo() override;
+
+	size_t size() const override;
+	void encode(std::string& buffer) const override;
 };
 
 class ActionRemove : public Action
@@ -39,20 +65,40 @@ public:
 
 	void executeUndo() override;
 	void executeRedo() override;
+
+	size_t size() const override;
+	void encode(std::string& buffer) const override;
 };
 
+// the fields of a dog changed by an update
+#define UPDATE_NAME 1
+#define UPDATE_BREED 2
+#define UPDATE_AGE 4
+#define UPDATE_PHOTOGRAPH 8
+
 class ActionUpdate : public Action
 {
 private:
-	Dog oldDog;
+	// the dog after the update, and only the fields it had
+	// before that changed, encoded one after the other
 	Dog newDog;
+	uint8_t changed = 0;
+	std::string delta;
 	Repository& repo;
+	int index;
 
 public:
-	ActionUpdate(const Dog& oldDog, const Dog& newDog, Repository& repo);
+	ActionUpdate(const Dog& oldDog, const Dog& newDog, Repository& repo, const int& index);
 
 	void executeUndo() override;
 	void executeRedo() override;
+
+	size_t size() const override;
+	void encode(std::string& buffer) const override;
+
+	Dog getOldDog() const;
+	const Dog& getNewDog() const { return this->newDog; }
+	uint8_t getChanged() const { return this->changed; }
 };
 
 class ActionAdopt : public Action
@@ -62,19 +108,38 @@ private:
 	Repository& repo;
 	int repoIndex;
 
-	Repository& dogsToShow;
+	DogView& dogsToShow;
 	int dogsToShowIndex;
 	AdoptionList* adoptionList;
 	int adoptionListIndex;
 
 public:
 	ActionAdopt(const Dog& dog, Repository& repo, const int& repoIndex,
-		Repository& dogsToShow, const int& dogsToShowIndex,
+		DogView& dogsToShow, const int& dogsToShowIndex,
 		AdoptionList* adoptionList, const int& adoptionListIndex);
 
 	void executeUndo() override;
 	void executeRedo() override;
 
+	size_t size() const override;
+	void encode(std::string& buffer) const override;
+
 	Dog getDog() const { return this->adoptedDog; }
 	int getDogsToShowIndex() const { return this->dogsToShowIndex; }
 };
+
+class ActionBatch : public Action
+{
+private:
+	std::vector<std::unique_ptr<Action>> actions;
+	Repository& repo;
+
+public:
+	ActionBatch(std::vector<std::unique_ptr<Action>> actions, Repository& repo);
+
+	void executeUndo() override;
+	void executeRedo() override;
+
+	size_t size() const override;
+	void encode(std::string& buffer) const override;
+};
@@ -6,11 +6,13 @@
 #include <QFormLayout>
 #include "AdminGUI.h"
 
-AdminGUI::AdminGUI(Service& serv, QWidget* modeSelector, QWidget* parent) : QWidget{ parent }, modeSelector{ modeSelector }, serv{ serv }
+AdminGUI::AdminGUI(Service& serv, QWidget* modeSelector, QWidget* parent) : QWidget{ parent }, modeSelector{ modeSelector }, serv{ serv }, dispatcher{ serv }, dogFilter{ serv.getRepo() }
 {
 	this->initGUI();
 	this->center();
 	this->connectSignalsAndSlots();
+
+	this->dispatcher.setRefreshScheduler([this]() { this->scheduleRefresh(); });
 }
 
 void AdminGUI::showEvent(QShowEvent* e)
@@ -27,7 +29,11 @@ void AdminGUI::initGUI()
 	QHBoxLayout* mainHLayout = new QHBoxLayout{ this };
 
 	// left side - just the list
-	this->dogsList = new QListWidget{};
+	this->dogsModel = new DogListModel{ this->serv.getRepo(), this };
+	this->dogsList = new QListView{};
+	this->dogsList->setModel(this->dogsModel);
+	// every row has the same height, so the view only lays out the visible ones
+	this->dogsList->setUniformItemSizes(true);
 	// set the selection model
 	this->dogsList->setSelectionMode(QAbstractItemView::SingleSelection);
 	
@@ -52,6 +58,9 @@ void AdminGUI::initGUI()
 	QFormLayout* formLayout = new QFormLayout{ dogDataWidget };
 	
 	this->filterEdit = new QLineEdit{};
+	this->filterTimer = new QTimer{ this };
+	this->filterTimer->setSingleShot(true);
+	this->filterTimer->setInterval(FILTER_DEBOUNCE_MS);
 	this->dogNameEdit = new QLineEdit{};
 	this->dogBreedEdit = new QLineEdit{};
 	this->dogAgeEdit = new QLineEdit{};
@@ -152,12 +161,14 @@ void AdminGUI::center()
 void AdminGUI::connectSignalsAndSlots()
 {
 	// when the list of dogs is updated - re-populate the list
-	QObject::connect(this->filterEdit, &QLineEdit::textChanged, this, &AdminGUI::filter);
+	// filter once the user stops typing instead of on every keystroke
+	QObject::connect(this->filterEdit, &QLineEdit::textChanged, this->filterTimer, qOverload<>(&QTimer::start));
+	QObject::connect(this->filterTimer, &QTimer::timeout, this, [this]() { this->filter(this->filterEdit->text()); });
 	QObject::connect(this, &AdminGUI::dogsUpdatedSignal, this, &AdminGUI::populateDogsList);
 	QObject::connect(this, &AdminGUI::loadDogsSignal, this, &AdminGUI::loadDogs);
 
 	// add a connection: function listItemChanged() will be called when an item in the list is selected
-	QObject::connect(this->dogsList, &QListWidget::itemSelectionChanged, this, [this]() { this->listItemChanged(); });
+	QObject::connect(this->dogsList->selectionModel(), &QItemSelectionModel::selectionChanged, this, [this]() { this->listItemChanged(); });
 
 	// add button connections
 	QObject::connect(this->addDogButton, &QPushButton::clicked, this, &AdminGUI::addDogButtonHandler);
@@ -165,16 +176,6 @@ void AdminGUI::connectSignalsAndSlots()
 	QObject::connect(this->updateDogButton, &QPushButton::clicked, this, &AdminGUI::updateDogButtonHandler);
 	QObject::connect(this->changeModeButton, &QPushButton::clicked, this, &AdminGUI::changeModeButtonHandler);
 
-	// connect the signals
-	QObject::connect(this, SIGNAL(addDogSignal(const std::string&, const std::string&, const int&, const std::string&)),
-		this, SLOT(addDog(const std::string&, const std::string&, const int&, const std::string&)));
-
-	QObject::connect(this, SIGNAL(removeDogSignal(const std::string&, const std::string&)),
-		this, SLOT(removeDog(const std::string&, const std::string&)));
-
-	QObject::connect(this, SIGNAL(updateDogSignal(const std::string&, const std::string&, const std::string&, const std::string&, const int&, const std::string&)),
-		this, SLOT(updateDog(const std::string&, const std::string&, const std::string&, const std::string&, const int&, const std::string&)));
-
 	// create shortcuts
 	this->undoShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Z), this);
 	this->redoShortcut = new QShortcut(QKeySequence(Qt::CTRL | Qt::Key_Y), this);
@@ -205,12 +206,25 @@ void AdminGUI::populateDogsList()
 	}
 
 	int oldIndex = this->getSelectedIndex();
-	this->dogsList->clear();
-	
-	this->dogsToShow = this->serv.getRepo().getDogs();
+
+	// the model follows the changes of the repository by itself
+	if (this->dogsModel->isFiltered())
+		this->dogsModel->showAll();
+
 	emit loadDogsSignal(oldIndex);
 }
 
+// refresh the list once the events queued so far are handled,
+// the commands run meanwhile share the refresh
+void AdminGUI::scheduleRefresh()
+{
+	QTimer::singleShot(0, this, [this]()
+		{
+			this->dispatcher.refreshed();
+			this->populateDogsList();
+		});
+}
+
 void AdminGUI::filter(const QString& qstr)
 {
 	std::string text = qstr.toStdString();
@@ -222,47 +236,38 @@ void AdminGUI::filter(const QString& qstr)
 
 	int oldIndex = this->getSelectedIndex();
 	if (text.size() == 1) oldIndex = 0;
-	this->dogsList->clear();
 
-	this->dogsToShow = this->serv.filterByString(text).getDogs();
+	this->dogsModel->showPositions(this->dogFilter.filter(text));
 	emit loadDogsSignal(oldIndex);
 }
 
 void AdminGUI::loadDogs(int oldIndex)
 {
-	for (auto& dog : this->dogsToShow)
-	{
-		QString itemInList = QString::fromStdString(dog.getName() + " - " + dog.getBreed());
-		QListWidgetItem* item = new QListWidgetItem{ itemInList };
-
-		QFont f{ "Arial", 14 };
-		item->setFont(f);
-
-		this->dogsList->addItem(item);
-	}
+	const Repository& repo = this->serv.getRepo();
+	int count = this->dogsModel->rowCount();
 
 	// set the selection to the previous one
 	// (if possible) so the cursor doesn't jump
-	if (oldIndex == -1 || this->dogsList->count() == 0)
+	if (oldIndex == -1 || count == 0)
 	{
-		this->dogsList->setCurrentRow(0);
+		this->dogsList->setCurrentIndex(this->dogsModel->index(0));
 
-		if (this->dogsList->count() > 0)
-			this->selectedDog = this->dogsToShow[0];
+		if (count > 0)
+			this->selectedId = repo[this->dogsModel->positionOf(0)].getId();
 		else
-			this->selectedDog = Dog{};
+			this->selectedId = 0;
 	}
 	else
 	{
-		while (oldIndex >= this->dogsList->count())
+		while (oldIndex >= count)
 			oldIndex--;
 
-		this->dogsList->setCurrentRow(oldIndex);
-		this->selectedDog = this->dogsToShow[oldIndex];
+		this->dogsList->setCurrentIndex(this->dogsModel->index(oldIndex));
+		this->selectedId = repo[this->dogsModel->positionOf(oldIndex)].getId();
 	}
 
-	this->deleteDogButton->setEnabled(this->dogsList->count() > 0);
-	this->updateDogButton->setEnabled(this->dogsList->count() > 0);
+	this->deleteDogButton->setEnabled(count > 0);
+	this->updateDogButton->setEnabled(count > 0);
 
 	this->undoButton->setEnabled(true);
 	this->redoButton->setEnabled(true);
@@ -271,11 +276,11 @@ void AdminGUI::loadDogs(int oldIndex)
 void AdminGUI::listItemChanged()
 {
 	int index = this->getSelectedIndex();
-	if (index == -1 || index >= this->dogsToShow.size())
+	if (index == -1 || index >= this->dogsModel->rowCount())
 		return;
 
-	Dog dog = this->dogsToShow[index];
-	this->selectedDog = dog;
+	Dog dog = this->serv.getRepo()[this->dogsModel->positionOf(index)];
+	this->selectedId = dog.getId();
 
 	this->dogNameEdit->setText(QString::fromStdString(dog.getName()));
 	this->dogBreedEdit->setText(QString::fromStdString(dog.getBreed()));
@@ -285,7 +290,7 @@ void AdminGUI::listItemChanged()
 
 int AdminGUI::getSelectedIndex()
 {
-	if (this->dogsList->count() == 0)
+	if (this->dogsModel->rowCount() == 0)
 		return -1;
 
 	// get selected index
@@ -313,7 +318,7 @@ void AdminGUI::addDogButtonHandler()
 	int age = ageStr.size() == 0 || ageStr.find_first_not_of("0123456789") != std::string::npos ? -1 : std::stoi(ageStr);
 	std::string photograph = this->dogPhotographEdit->toPlainText().toStdString();
 
-	emit addDogSignal(name, breed, age, photograph);
+	this->addDog(name, breed, age, photograph);
 }
 
 void AdminGUI::deleteDogButtonHandler()
@@ -323,7 +328,7 @@ void AdminGUI::deleteDogButtonHandler()
 	std::string name = this->dogNameEdit->text().toStdString();
 	std::string breed = this->dogBreedEdit->text().toStdString();
 
-	emit removeDogSignal(name, breed);
+	this->removeDog(name, breed);
 }
 
 void AdminGUI::updateDogButtonHandler()
@@ -336,7 +341,16 @@ void AdminGUI::updateDogButtonHandler()
 	int age = ageStr.size() == 0 || ageStr.find_first_not_of("0123456789") != std::string::npos ? -1 : std::stoi(ageStr);
 	std::string photograph = this->dogPhotographEdit->toPlainText().toStdString();
 
-	emit updateDogSignal(this->selectedDog.getName(), this->selectedDog.getBreed(), name, breed, age, photograph);
+	// the selected dog goes by the name it has now, even if it was renamed since
+	int position = this->serv.getRepo().indexOfId(this->selectedId);
+	if (position == -1)
+	{
+		this->showError("The selected dog does not exist anymore!");
+		return;
+	}
+
+	const Dog& selectedDog = this->serv.getRepo()[position];
+	this->updateDog(selectedDog.getName(), selectedDog.getBreed(), name, breed, age, photograph);
 }
 
 void AdminGUI::changeModeButtonHandler()
@@ -349,8 +363,7 @@ void AdminGUI::undo()
 {
 	try
 	{
-		this->serv.undo();
-		emit dogsUpdatedSignal();
+		this->dispatcher.submit(BatchOperation::undo());
 	
 		this->showInformation("The last operation was undone successfully.");
 	}
@@ -364,8 +377,7 @@ void AdminGUI::redo()
 {
 	try
 	{
-		this->serv.redo();
-		emit dogsUpdatedSignal();
+		this->dispatcher.submit(BatchOperation::redo());
 
 		this->showInformation("The last operation was redone successfully.");
 	}
@@ -384,8 +396,7 @@ void AdminGUI::addDog(const std::string& name, const std::string& breed, const i
 {
 	try
 	{
-		this->serv.add(name, breed, age, photograph);
-		emit dogsUpdatedSignal();
+		this->dispatcher.submit(BatchOperation::add(name, breed, age, photograph));
 
 		emit clearUserUndoRedoSignal();
 		this->showInformation("The dog has been added to the shelter.");
@@ -408,8 +419,7 @@ void AdminGUI::removeDog(const std::string& name, const std::string& breed)
 {
 	try
 	{
-		this->serv.remove(name, breed);
-		emit dogsUpdatedSignal();
+		this->dispatcher.submit(BatchOperation::remove(name, breed));
 
 		emit clearUserUndoRedoSignal();
 		this->showInformation("The dog has been removed from the shelter.");
@@ -432,8 +442,7 @@ void AdminGUI::updateDog(const std::string& oldName, const std::string& oldBreed
 {
 	try
 	{
-		this->serv.update(oldName, oldBreed, name, breed, age, photograph);
-		emit dogsUpdatedSignal();
+		this->dispatcher.submit(BatchOperation::update(oldName, oldBreed, name, breed, age, photograph));
 
 		emit clearUserUndoRedoSignal();
 		this->showInformation("The dog was updated with the new information.");
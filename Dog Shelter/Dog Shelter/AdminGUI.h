@@ -1,13 +1,17 @@
 #pragma once
 
 #include <qwidget.h>
-#include <QListWidget>
+#include <QListView>
 #include <QLineEdit>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QShortcut>
+#include <QTimer>
 #include "Service.h"
+#include "CommandDispatcher.h"
 #include "Dog.h"
+#include "IncrementalFilter.h"
+#include "DogListModel.h"
 
 class AdminGUI : public QWidget
 {
@@ -15,17 +19,24 @@ class AdminGUI : public QWidget
 
 public:
 	AdminGUI(Service& serv, QWidget* modeSelector, QWidget* parent = Q_NULLPTR);
-	~AdminGUI() = default;
+
+	// the latency of the commands and the number of list refreshes
+	const CommandDispatcher& getDispatcher() const { return this->dispatcher; }
 
 private:
 	QWidget* modeSelector;
 	Service& serv;
-	std::vector<Dog> dogsToShow;
-	Dog selectedDog;
+	// every change of the shelter goes through it, the list is refreshed once per frame
+	CommandDispatcher dispatcher;
+	IncrementalFilter dogFilter;
+	// the id of the selected dog, it survives the dog being renamed
+	uint64_t selectedId = 0;
 	
-	QListWidget* dogsList;
+	DogListModel* dogsModel;
+	QListView* dogsList;
 
 	QLineEdit* filterEdit;
+	QTimer* filterTimer;
 	QLineEdit* dogNameEdit;
 	QLineEdit* dogBreedEdit;
 	QLineEdit* dogAgeEdit;
@@ -49,6 +60,7 @@ private:
 	void showError(const std::string& err);
 
 	void populateDogsList();
+	void scheduleRefresh();
 	void listItemChanged();
 	int getSelectedIndex();
 
@@ -57,14 +69,14 @@ private:
 	void updateDogButtonHandler();
 	void changeModeButtonHandler();
 
+	void addDog(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
+	void removeDog(const std::string& name, const std::string& breed);
+	void updateDog(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
+
 signals:
 	void dogsUpdatedSignal();
 	void loadDogsSignal(int oldIndex = 0);
 
-	void addDogSignal(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
-	void removeDogSignal(const std::string& name, const std::string& breed);
-	void updateDogSignal(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
-	
 	void clearUserUndoRedoSignal();
 
 public slots:
@@ -74,9 +86,5 @@ public slots:
 	void undo();
 	void redo();
 
-	void addDog(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
-	void removeDog(const std::string& name, const std::string& breed);
-	void updateDog(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
-
 	void clearUndoRedo();
 };
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 #include "AdoptionList.h"
 #include "Validator.h"
+#include "FileUtils.h"
 
 /// <summary>
 /// Adds a dog to the adoption list
@@ -10,8 +12,33 @@
 void AdoptionList::add(const Dog& dog, int index)
 {
 	if (index < 0 || index > this->size()) index = this->size();
-	this->dogs.insert(this->dogs.begin() + index, dog);
-	this->write();
+
+	this->notifyBeforeInsert(index);
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.insert(this->dogs.begin() + index, dog);
+	}
+	this->notifyAfterInsert(index);
+
+	this->persistAdd(index);
+}
+
+/// <summary>
+/// Finds a dog of the adoption list by its id, the dogs read back
+/// from a file have none and are found by name and breed instead
+/// </summary>
+/// <param name="dog">the dog to find</param>
+/// <returns>the position of the dog, the end of the dogs if it is missing</returns>
+std::vector<Dog>::iterator AdoptionList::find(const Dog& dog)
+{
+	if (dog.getId() != 0)
+	{
+		auto it = std::find_if(this->dogs.begin(), this->dogs.end(), [&dog](const Dog& other) { return other.getId() == dog.getId(); });
+		if (it != this->dogs.end())
+			return it;
+	}
+
+	return std::find(this->dogs.begin(), this->dogs.end(), dog);
 }
 
 /// <summary>
@@ -20,9 +47,19 @@ void AdoptionList::add(const Dog& dog, int index)
 /// <param name="dog">the dog to remove</param>
 void AdoptionList::remove(const Dog& dog)
 {
-	auto it = std::find(this->dogs.begin(), this->dogs.end(), dog);
-	this->dogs.erase(it);
-	this->write();
+	auto it = this->find(dog);
+	if (it == this->dogs.end())
+		return;
+
+	int index = static_cast<int>(it - this->dogs.begin());
+	this->notifyBeforeRemove(index);
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.erase(it);
+	}
+	this->notifyAfterRemove(index);
+
+	this->persistRemove(index);
 }
 
 /// <summary>
@@ -32,14 +69,107 @@ void AdoptionList::remove(const Dog& dog)
 /// <param name="newDog">the new dog</param>
 void AdoptionList::update(const Dog& oldDog, const Dog& newDog)
 {
-	for (auto& dog : this->dogs)
+	auto it = this->find(oldDog);
+	if (it == this->dogs.end())
+		return;
+
+	int index = static_cast<int>(it - this->dogs.begin());
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		*it = newDog;
+	}
+	this->notifyAfterUpdate(index);
+
+	this->persistUpdate(index);
+}
+
+/// <summary>
+/// Copies the dogs, called by the persistence worker
+/// while the list may be changing them
+/// </summary>
+/// <returns>the dogs as they are now</returns>
+std::vector<Dog> AdoptionList::snapshot()
+{
+	std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+	return this->dogs;
+}
+
+/// <summary>
+/// Formats rows of dogs as CSV in memory
+/// </summary>
+/// <param name="first">the first dog to format</param>
+/// <param name="last">the end of the dogs to format</param>
+/// <returns>the rows, one per line</returns>
+static std::string formatRows(std::vector<Dog>::const_iterator first, std::vector<Dog>::const_iterator last)
+{
+	std::ostringstream rows;
+	for (; first != last; ++first)
+		rows << *first;
+
+	return rows.str();
+}
+
+/// <summary>
+/// Waits until the files of the list are on the disk
+/// </summary>
+void AdoptionList::flush()
+{
+	if (this->worker != nullptr)
+		this->worker->flush();
+}
+
+/// <summary>
+/// The one output path of the CSV file: the rows from a dog to the
+/// last one are written all at once, by the persistence worker if set
+/// </summary>
+/// <param name="first">the first dog to write</param>
+/// <param name="append">true to append to the file, false to replace it</param>
+void CSVAdoptionList::output(std::vector<Dog>::const_iterator first, const bool& append)
+{
+	std::string path = this->fileName + this->extension;
+
+	if (this->worker != nullptr)
+	{
+		if (append)
+			this->worker->append(path, formatRows(first, this->dogs.cend()));
+		else
+			// the rows are formatted on the worker from a copy of the list made there,
+			// the dogs adopted after this call are in the appends that follow it
+			this->worker->replace(path, [this, count = this->dogs.size()]()
+				{
+					std::vector<Dog> dogs = this->snapshot();
+					dogs.resize(std::min(count, dogs.size()));
+					return formatRows(dogs.cbegin(), dogs.cend());
+				});
+		return;
+	}
+
+	std::string data = formatRows(first, this->dogs.cend());
+	if (!append)
+	{
+		FileUtils::writeDurably(path, data);
+		return;
+	}
+
+	std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::app);
+	if (!f.is_open())
+		throw FileException("The file could not be opened!");
+
+	f.write(data.data(), static_cast<std::streamsize>(data.size()));
+	f.close();
+}
+
+/// <summary>
+/// Writes the pending changes before the list goes away
+/// </summary>
+CSVAdoptionList::~CSVAdoptionList()
+{
+	try
+	{
+		this->flush();
+	}
+	catch (FileException&)
 	{
-		if (dog == oldDog)
-		{
-			dog = newDog;
-			this->write();
-			return;
-		}
 	}
 }
 
@@ -49,16 +179,63 @@ void AdoptionList::update(const Dog& oldDog, const Dog& newDog)
 /// </summary>
 void CSVAdoptionList::write()
 {
-	std::ofstream f(this->fileName + this->extension);
-	if (!f.is_open())
-		throw FileException("The file could not be opened!");
+	this->output(this->dogs.cbegin(), false);
+
+	this->synced = true;
+	this->pendingChanges = 0;
+}
+
+/// <summary>
+/// Writes the table again if removals or updates are
+/// pending and waits until it is on the disk
+/// </summary>
+void CSVAdoptionList::flush()
+{
+	if (!this->synced)
+		this->write();
+
+	AdoptionList::flush();
+}
 
-	for (const Dog& dog : this->dogs)
+/// <summary>
+/// A dog adopted last is appended to the file,
+/// one put back in the middle waits for the compaction
+/// </summary>
+/// <param name="index">the position of the new dog</param>
+void CSVAdoptionList::persistAdd(const int& index)
+{
+	// the file left by an earlier run is replaced by the first change
+	if (!this->synced && this->pendingChanges == 0)
 	{
-		f << dog;
+		this->write();
+		return;
 	}
 
-	f.close();
+	if (index == this->size() - 1)
+	{
+		// the pending changes are compacted first, so the
+		// adoptions after this one are appended again
+		if (!this->synced)
+			this->write();
+		else
+			this->output(this->dogs.cbegin() + index, true);
+		return;
+	}
+
+	this->batch();
+}
+
+/// <summary>
+/// Removals and updates are batched, the file is
+/// compacted once enough of them are pending
+/// </summary>
+void CSVAdoptionList::batch()
+{
+	this->synced = false;
+	this->pendingChanges++;
+
+	if (this->pendingChanges >= ADOPTION_COMPACT_THRESHOLD)
+		this->write();
 }
 
 /// <summary>
@@ -67,40 +244,59 @@ void CSVAdoptionList::write()
 /// </summary>
 void CSVAdoptionList::open()
 {
+	this->flush();
+
 	std::string command = "notepad ";
 	system(command.append(this->fileName + this->extension).c_str());
 }
 
 /// <summary>
-/// Override the write function to write
-/// an HTML table of the adoption list
+/// Override the write function to write the pages
+/// of the HTML report changed since the last write
 /// </summary>
 void HTMLAdoptionList::write()
 {
-	std::ofstream f(this->fileName + this->extension);
-	if (!f.is_open())
-		throw FileException("The file could not be opened!");
+	this->report.write(this->dogs);
+}
 
-	f << "<!DOCTYPE html><html><head><title>Adoption List</title></head><body><table border=\"1\" cellpadding=\"5\" cellspacing=\"5\">";
-	f << "<tr>";
-	f << "<th>Name</th>";
-	f << "<th>Breed</th>";
-	f << "<th>Age</th>";
-	f << "<th>Photograph</th>";
-	f << "</tr>";
+/// <summary>
+/// Hands the pages of the report to the persistence worker
+/// </summary>
+/// <param name="worker">the worker writing the pages</param>
+void HTMLAdoptionList::setPersistenceWorker(PersistenceWorker* worker)
+{
+	AdoptionList::setPersistenceWorker(worker);
+	this->report.setPersistenceWorker(worker);
+}
 
-	for (const Dog& dog : this->dogs)
-	{
-		f << "<tr>";
-		f << "<td>" + dog.getName() + "</td>";
-		f << "<td>" + dog.getBreed() + "</td>";
-		f << "<td>" + std::to_string(dog.getAge()) + "</td>";
-		f << "<td><a href=\"" + dog.getPhotohraph() + "\">link</a></td>";
-		f << "</tr>";
-	}
+/// <summary>
+/// A new dog moves the rows after it to the following pages
+/// </summary>
+/// <param name="index">the position of the new dog</param>
+void HTMLAdoptionList::persistAdd(const int& index)
+{
+	this->report.shifted(index);
+	this->write();
+}
 
-	f << "</table></body></html>";
-	f.close();
+/// <summary>
+/// A removed dog moves the rows after it to the previous pages
+/// </summary>
+/// <param name="index">the former position of the dog</param>
+void HTMLAdoptionList::persistRemove(const int& index)
+{
+	this->report.shifted(index);
+	this->write();
+}
+
+/// <summary>
+/// An updated dog changes only its own page
+/// </summary>
+/// <param name="index">the position of the dog</param>
+void HTMLAdoptionList::persistUpdate(const int& index)
+{
+	this->report.changed(index);
+	this->write();
 }
 
 /// <summary>
@@ -109,6 +305,8 @@ void HTMLAdoptionList::write()
 /// </summary>
 void HTMLAdoptionList::open()
 {
+	this->flush();
+
 	std::string command = "start ";
 
 	try
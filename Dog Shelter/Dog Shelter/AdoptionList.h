@@ -2,13 +2,34 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
 #include "Dog.h"
+#include "Observer.h"
+#include "HTMLReport.h"
+#include "PersistenceWorker.h"
 
-class AdoptionList
+// number of removals and updates after which the CSV file is compacted
+#define ADOPTION_COMPACT_THRESHOLD 64
+
+class AdoptionList : public Observable
 {
 protected:
 	std::vector<Dog> dogs;
+	// guards the changes to the dogs against the copy the persistence
+	// worker makes, see Repository::dogsMutex
+	std::shared_ptr<std::mutex> dogsMutex = std::make_shared<std::mutex>();
 	std::string fileName = "Dogs";
+	// writes the files in the background when set
+	PersistenceWorker* worker = nullptr;
+
+	// called after each change, by default the whole file is written again
+	virtual void persistAdd(const int&) { this->write(); }
+	virtual void persistRemove(const int&) { this->write(); }
+	virtual void persistUpdate(const int&) { this->write(); }
+
+	std::vector<Dog>::iterator find(const Dog& dog);
+	std::vector<Dog> snapshot();
 
 public:
 	AdoptionList() = default;
@@ -19,9 +40,14 @@ public:
 	void update(const Dog& oldDog, const Dog& newDog);
 
 	virtual void write() = 0;
+	virtual void flush();
 	virtual void open() = 0;
 
+	virtual void setPersistenceWorker(PersistenceWorker* worker) { this->worker = worker; }
+
 	std::vector<Dog>& getDogs() { return this->dogs; };
+	const std::vector<Dog>& getDogs() const { return this->dogs; };
+	const Dog& operator[](const int& index) const { return this->dogs[index]; };
 	int size() const { return static_cast<int>(this->dogs.size()); };
 };
 
@@ -30,10 +56,24 @@ class CSVAdoptionList : public AdoptionList
 private:
 	std::string extension = ".csv";
 
+	// the file holds every dog once the pending removals and updates are written
+	bool synced = false;
+	int pendingChanges = 0;
+
+	void batch();
+	void output(std::vector<Dog>::const_iterator first, const bool& append);
+
+protected:
+	void persistAdd(const int& index) override;
+	void persistRemove(const int&) override { this->batch(); }
+	void persistUpdate(const int&) override { this->batch(); }
+
 public:
 	CSVAdoptionList() = default;
+	~CSVAdoptionList();
 
 	void write() override;
+	void flush() override;
 	void open() override;
 };
 
@@ -41,10 +81,18 @@ class HTMLAdoptionList : public AdoptionList
 {
 private:
 	std::string extension = ".html";
+	HTMLReport report{ this->fileName };
+
+protected:
+	void persistAdd(const int& index) override;
+	void persistRemove(const int& index) override;
+	void persistUpdate(const int& index) override;
 
 public:
 	HTMLAdoptionList() = default;
 
 	void write() override;
 	void open() override;
+
+	void setPersistenceWorker(PersistenceWorker* worker) override;
 };
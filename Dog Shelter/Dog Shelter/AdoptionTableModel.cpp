@@ -2,7 +2,17 @@
 #include <QBrush>
 #include "AdoptionTableModel.h"
 
-AdoptionTableModel::AdoptionTableModel(AdoptionList* adoptionList, QObject* parent) : QAbstractTableModel{ parent }, adoptionList{ adoptionList } { }
+AdoptionTableModel::AdoptionTableModel(AdoptionList* adoptionList, QObject* parent) : QAbstractTableModel{ parent }, adoptionList{ adoptionList },
+	cellFont{ "Arial", 14 }, headerFont{ "Arial", 15 }, oddRowBrush{ Qt::white }
+{
+	this->headerFont.setBold(true);
+	this->adoptionList->addObserver(this);
+}
+
+AdoptionTableModel::~AdoptionTableModel()
+{
+	this->adoptionList->removeObserver(this);
+}
 
 int AdoptionTableModel::rowCount(const QModelIndex& parent) const
 {
@@ -20,16 +30,13 @@ QVariant AdoptionTableModel::data(const QModelIndex& index, int role) const
 	int row = index.row();
 	int column = index.column();
 
-	// get the dogs
-	std::vector<Dog> dogs = this->adoptionList->getDogs();
-
 	// Allow adding in the table
 	// this is to show an empty row at the end of the table - to allow adding new dogs
-	if (row == dogs.size())
+	if (row >= this->adoptionList->size())
 		return QVariant{};
 
 	// get the dog from the current row
-	Dog dog = dogs[row];
+	const Dog& dog = (*this->adoptionList)[row];
 	if (role == Qt::DisplayRole || role == Qt::EditRole)
 	{
 		switch (column)
@@ -47,14 +54,11 @@ QVariant AdoptionTableModel::data(const QModelIndex& index, int role) const
 		}
 	}
 	if (role == Qt::FontRole)
-	{
-		QFont font{ "Arial", 14 };
-		return font;
-	}
+		return this->cellFont;
 	if (role == Qt::BackgroundRole)
 	{
 		if (row % 2 == 1)
-			return QBrush{ Qt::white }; // QBrush{ Qt::lightGray };
+			return this->oddRowBrush; // QBrush{ Qt::lightGray };
 	}
 
 	return QVariant{};
@@ -82,11 +86,7 @@ QVariant AdoptionTableModel::headerData(int section, Qt::Orientation orientation
 		}
 	}
 	if (role == Qt::FontRole)
-	{
-		QFont font{ "Arial", 15 };
-		font.setBold(true);
-		return font;
-	}
+		return this->headerFont;
 
 	return QVariant{};
 }
@@ -102,18 +102,14 @@ bool AdoptionTableModel::setData(const QModelIndex& index, const QVariant& value
 	// set the new data to the dog
 	int dogIndex = index.row();
 
-	// get the dogs
-	std::vector<Dog> dogs = this->adoptionList->getDogs();
-
 	std::string valueStr = value.toString().toStdString();
 	int age = valueStr.size() == 0 || valueStr.find_first_not_of("0123456789") != std::string::npos ? -1 : std::stoi(valueStr);
 
 	// Allow adding in the table
 	//if the index is >= number of dogs => a new dog is added
-	if (dogIndex == dogs.size())
+	// the rows are inserted through the notifications of the adoption list
+	if (dogIndex == this->adoptionList->size())
 	{
-		this->beginInsertRows(QModelIndex{}, dogIndex, dogIndex);
-
 		switch (index.column())
 		{
 		case 0:
@@ -130,12 +126,11 @@ bool AdoptionTableModel::setData(const QModelIndex& index, const QVariant& value
 			break;
 		}
 
-		this->endInsertRows();
 		return true;
 	}
 
-	Dog& currentDog = dogs[dogIndex];
-	Dog oldDog = currentDog;
+	Dog oldDog = (*this->adoptionList)[dogIndex];
+	Dog currentDog = oldDog;
 	switch (index.column())
 	{
 	case 0:
@@ -151,10 +146,8 @@ bool AdoptionTableModel::setData(const QModelIndex& index, const QVariant& value
 		currentDog.setPhotograph(valueStr);
 		break;
 	}
+	// dataChanged is emitted through the notifications of the adoption list
 	this->adoptionList->update(oldDog, currentDog);
-
-	// emit the dataChanged signal
-	emit dataChanged(index, index);
 	return true;
 }
 
@@ -162,3 +155,42 @@ Qt::ItemFlags AdoptionTableModel::flags(const QModelIndex& index) const
 {
 	return Qt::ItemIsEnabled; // | Qt::ItemIsSelectable | Qt::ItemIsEditable;
 }
+
+void AdoptionTableModel::photographChanged(const QString& url)
+{
+	std::string photograph = url.toStdString();
+
+	for (int row = 0; row < this->adoptionList->size(); row++)
+	{
+		if ((*this->adoptionList)[row].getPhotohraph() == photograph)
+		{
+			QModelIndex changed = this->index(row, 3);
+			emit dataChanged(changed, changed, { Qt::DisplayRole });
+		}
+	}
+}
+
+void AdoptionTableModel::beforeInsert(const int& index)
+{
+	this->beginInsertRows(QModelIndex{}, index, index);
+}
+
+void AdoptionTableModel::afterInsert(const int&)
+{
+	this->endInsertRows();
+}
+
+void AdoptionTableModel::beforeRemove(const int& index)
+{
+	this->beginRemoveRows(QModelIndex{}, index, index);
+}
+
+void AdoptionTableModel::afterRemove(const int&)
+{
+	this->endRemoveRows();
+}
+
+void AdoptionTableModel::afterUpdate(const int& index)
+{
+	emit dataChanged(this->index(index, 0), this->index(index, this->columnCount() - 1));
+}
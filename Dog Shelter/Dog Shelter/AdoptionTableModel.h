@@ -1,16 +1,24 @@
 #pragma once
 
 #include <QAbstractTableModel>
+#include <QFont>
+#include <QBrush>
 #include "AdoptionList.h"
+#include "Observer.h"
 
-class AdoptionTableModel : public QAbstractTableModel
+class AdoptionTableModel : public QAbstractTableModel, public Observer
 {
 private:
 	AdoptionList* adoptionList;
 
+	// the role values are the same for every cell
+	QFont cellFont;
+	QFont headerFont;
+	QBrush oddRowBrush;
+
 public:
 	AdoptionTableModel(AdoptionList* adoptionList, QObject* parent = Q_NULLPTR);
-	~AdoptionTableModel() = default;
+	~AdoptionTableModel();
 
 	// number of rows
 	int rowCount(const QModelIndex& parent = QModelIndex{}) const override;
@@ -29,4 +37,14 @@ public:
 
 	// used to set certain properties of a cell
 	Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+	// repaint the photograph cells showing an url
+	void photographChanged(const QString& url);
+
+	// adoption list changes
+	void beforeInsert(const int& index) override;
+	void afterInsert(const int& index) override;
+	void beforeRemove(const int& index) override;
+	void afterRemove(const int& index) override;
+	void afterUpdate(const int& index) override;
 };
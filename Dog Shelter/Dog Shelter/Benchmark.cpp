@@ -0,0 +1,243 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "Benchmark.h"
+#include "Repository.h"
+#include "DogView.h"
+#include "AdoptionList.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include "Utils.h"
+
+/// <summary>
+/// Measures the time a function takes
+/// </summary>
+/// <param name="function">the function to measure</param>
+/// <returns>the elapsed time in milliseconds</returns>
+template <typename F>
+static double measure(F function)
+{
+	auto start = std::chrono::steady_clock::now();
+	function();
+	auto end = std::chrono::steady_clock::now();
+
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/// <summary>
+/// Prints the result of a benchmark
+/// </summary>
+/// <param name="name">the name of the benchmark</param>
+/// <param name="milliseconds">the elapsed time</param>
+static void report(const std::string& name, const double& milliseconds)
+{
+	std::cout << name << ": " << milliseconds << " ms" << std::endl;
+}
+
+/// <summary>
+/// Compares the stream based parser with the memory mapped loader
+/// </summary>
+void Benchmark::benchLoad()
+{
+	const char* breeds[] = { "poodle", "beagle", "landseer", "barbet", "pug", "shikoku", "maltese" };
+	std::string fileName = "BenchDogs.txt";
+
+	std::ofstream out(fileName);
+	for (int i = 0; i < BENCHMARK_DOGS; i++)
+		out << Dog{ "dog" + std::to_string(i), breeds[i % 7], i % 31, "https://example.com/dogs/" + std::to_string(i) + ".jpg" };
+	out.close();
+
+	std::vector<Dog> streamDogs;
+	report("load (ifstream + tokenize)", measure([&]()
+		{
+			std::ifstream f(fileName);
+			Dog dog{};
+			while (f >> dog)
+				streamDogs.push_back(dog);
+		}));
+
+	std::vector<Dog> mappedDogs;
+	report("load (mapped + string_view)", measure([&]()
+		{
+			MappedFile file{ fileName };
+			Dog dog{};
+			forEachLine(file.view(), [&](std::string_view line)
+				{
+					if (dog.parse(line))
+						mappedDogs.push_back(dog);
+				});
+		}));
+
+	report("Repository load (mapped + index)", measure([&]()
+		{
+			Repository repo{ true, fileName };
+		}));
+
+	std::remove(fileName.c_str());
+}
+
+/// <summary>
+/// Compares loading the text file with loading a binary snapshot
+/// </summary>
+void Benchmark::benchSnapshot()
+{
+	const char* breeds[] = { "poodle", "beagle", "landseer", "barbet", "pug", "shikoku", "maltese" };
+	std::string textName = "BenchDogs.txt";
+	std::string binaryName = "BenchDogs.bin";
+
+	{
+		Repository repo{};
+		for (int i = 0; i < BENCHMARK_DOGS; i++)
+			repo.add(Dog{ "dog" + std::to_string(i), breeds[i % 7], i % 31, "https://example.com/dogs/" + std::to_string(i) + ".jpg" });
+
+		repo.exportTo(textName, StorageFormat::Text);
+		report("export binary snapshot", measure([&]() { repo.exportTo(binaryName, StorageFormat::Binary); }));
+	}
+
+	std::vector<Dog> decoded;
+	report("decode binary snapshot", measure([&]()
+		{
+			MappedFile file{ binaryName };
+			SnapshotReader reader{ file.view() };
+			decoded.resize(reader.size());
+
+			for (size_t i = 0; i < reader.size(); i++)
+				reader.read(i, decoded[i]);
+		}));
+
+	report("Repository load (text)", measure([&]() { Repository repo{ true, textName }; }));
+	report("Repository load (binary)", measure([&]() { Repository repo{ true, binaryName }; }));
+
+	std::remove(textName.c_str());
+	std::remove(binaryName.c_str());
+}
+
+/// <summary>
+/// Compares filtering by comparing strings with scanning the breed and age columns
+/// </summary>
+void Benchmark::benchFilter()
+{
+	const char* breeds[] = { "poodle", "beagle", "landseer", "barbet", "pug", "shikoku", "maltese" };
+	Repository repo{};
+	for (int i = 0; i < BENCHMARK_DOGS; i++)
+		repo.add(Dog{ "dog" + std::to_string(i), breeds[i % 7], i % 31, "https://example.com/dogs/" + std::to_string(i) + ".jpg" });
+
+	size_t stringMatches = 0;
+	report("filter by breed and age (strings)", measure([&]()
+		{
+			for (const Dog& dog : repo.getDogs())
+				if (dog.getBreed() == "landseer" && dog.getAge() < 10)
+					stringMatches++;
+		}));
+
+	size_t columnMatches = 0;
+	report("filter by breed and age (columns)", measure([&]()
+		{
+			columnMatches = repo.filterByBreedAndAge("landseer", 10).size();
+		}));
+
+	// the matches are browsed in place instead of being copied out
+	size_t viewMatches = 0;
+	report("filter by breed and age (view, browsed)", measure([&]()
+		{
+			DogView view{ repo, repo.filterByBreedAndAge("landseer", 10) };
+			for (const Dog& dog : view)
+				viewMatches += dog.getPhotohraph().empty() ? 0 : 1;
+		}));
+
+	std::cout << "bytes per dog: " << sizeof(Dog) << ", breeds: " << BreedDictionary::size() << std::endl;
+	std::cout << "matches: " << stringMatches << " / " << columnMatches << " / " << viewMatches << std::endl;
+}
+
+/// <summary>
+/// Compares the linear name filter with the trigram index
+/// </summary>
+void Benchmark::benchSearch()
+{
+	const char* breeds[] = { "poodle", "beagle", "landseer", "barbet", "pug", "shikoku", "maltese" };
+	Repository repo{};
+	for (int i = 0; i < SEARCH_BENCHMARK_DOGS; i++)
+		repo.add(Dog{ "dog" + std::to_string(i), breeds[i % 7], i % 31, "https://example.com/dogs/" + std::to_string(i) + ".jpg" });
+
+	const char* queries[] = { "12345", "99999", "shikoku", "g4242" };
+	size_t linearMatches = 0;
+	size_t indexMatches = 0;
+
+	report("search (linear)", measure([&]()
+		{
+			for (const char* query : queries)
+				for (const Dog& dog : repo.getDogs())
+					if (dog.getName().find(query) != std::string::npos || dog.getBreed().find(query) != std::string::npos)
+						linearMatches++;
+		}));
+
+	report("build trigram index", measure([&]() { repo.search("dog"); }));
+
+	report("search (trigram index)", measure([&]()
+		{
+			for (const char* query : queries)
+				indexMatches += repo.search(query).size();
+		}));
+
+	report("search (trigram index, ignore case)", measure([&]()
+		{
+			for (const char* query : queries)
+				repo.search(query, true);
+		}));
+
+	std::cout << "matches: " << linearMatches << " / " << indexMatches << std::endl;
+}
+
+/// <summary>
+/// Compares writing the whole adoption list after each
+/// adoption with appending the adopted dog to the file,
+/// and with writing only the last page of the HTML report
+/// </summary>
+void Benchmark::benchAdoption()
+{
+	std::vector<Dog> dogs;
+	for (int i = 0; i < ADOPTION_BENCHMARK_DOGS; i++)
+		dogs.push_back(Dog{ "dog" + std::to_string(i), "poodle", i % 31, "https://example.com/dogs/" + std::to_string(i) + ".jpg" });
+
+	report("adopt one by one (rewrite)", measure([&]()
+		{
+			CSVAdoptionList adoptionList{};
+			for (const Dog& dog : dogs)
+			{
+				adoptionList.add(dog);
+				adoptionList.write();
+			}
+		}));
+
+	report("adopt one by one (append)", measure([&]()
+		{
+			CSVAdoptionList adoptionList{};
+			for (const Dog& dog : dogs)
+				adoptionList.add(dog);
+		}));
+
+	report("adopt one by one (html pages)", measure([&]()
+		{
+			HTMLAdoptionList adoptionList{};
+			for (const Dog& dog : dogs)
+				adoptionList.add(dog);
+		}));
+
+	std::remove("Dogs.csv");
+	for (int page = 0; page * HTML_REPORT_PAGE_SIZE < ADOPTION_BENCHMARK_DOGS; page++)
+		std::remove(HTMLReport{ "Dogs" }.pageName(page).c_str());
+}
+
+/// <summary>
+/// Runs all the benchmarks
+/// </summary>
+void Benchmark::runAllBenchmarks()
+{
+	benchLoad();
+	benchSnapshot();
+	benchFilter();
+	benchSearch();
+	benchAdoption();
+}
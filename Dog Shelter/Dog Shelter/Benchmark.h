@@ -0,0 +1,21 @@
+#pragma once
+
+// number of dogs generated for the benchmarks
+#define BENCHMARK_DOGS 500000
+// number of dogs generated for the search benchmark
+#define SEARCH_BENCHMARK_DOGS 1000000
+// number of dogs adopted one by one for the adoption list benchmark
+#define ADOPTION_BENCHMARK_DOGS 5000
+
+class Benchmark
+{
+private:
+	void benchLoad();
+	void benchSnapshot();
+	void benchFilter();
+	void benchSearch();
+	void benchAdoption();
+
+public:
+	void runAllBenchmarks();
+};
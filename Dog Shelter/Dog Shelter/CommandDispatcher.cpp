@@ -0,0 +1,125 @@
+#include <chrono>
+#include <exception>
+#include "CommandDispatcher.h"
+
+/// <summary>
+/// The average time a command took
+/// </summary>
+/// <returns>the average in microseconds, 0 if no command ran</returns>
+double CommandStats::averageMicroseconds() const
+{
+	return this->count == 0 ? 0.0 : static_cast<double>(this->total) / this->count / 1000.0;
+}
+
+/// <summary>
+/// The name of a type of command, for the logs
+/// </summary>
+/// <param name="type">the type of the command</param>
+/// <returns>the name</returns>
+const char* CommandDispatcher::nameOf(const OperationType& type)
+{
+	switch (type)
+	{
+	case OperationType::Add: return "add";
+	case OperationType::Remove: return "remove";
+	case OperationType::Update: return "update";
+	case OperationType::Undo: return "undo";
+	case OperationType::Redo: return "redo";
+	}
+
+	return "unknown";
+}
+
+/// <summary>
+/// Queues a command and runs the queue, a command submitted while
+/// another one runs waits for it; the first error of the commands run
+/// is thrown once the queue is empty
+/// </summary>
+/// <param name="command">the command to run</param>
+void CommandDispatcher::submit(const BatchOperation& command)
+{
+	this->queue.push_back(command);
+	if (this->running)
+		return;
+
+	this->running = true;
+	std::exception_ptr error;
+
+	while (!this->queue.empty())
+	{
+		BatchOperation next = std::move(this->queue.front());
+		this->queue.pop_front();
+
+		try
+		{
+			this->run(next);
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+
+	this->running = false;
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+/// <summary>
+/// Runs a command and times it, a command that went through
+/// makes a refresh due unless one already is
+/// </summary>
+/// <param name="command">the command to run</param>
+void CommandDispatcher::run(const BatchOperation& command)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	switch (command.type)
+	{
+	case OperationType::Add:
+		this->serv.add(command.dog.getName(), command.dog.getBreed(), command.dog.getAge(), command.dog.getPhotohraph());
+		break;
+	case OperationType::Remove:
+		this->serv.remove(command.name, command.breed);
+		break;
+	case OperationType::Update:
+		this->serv.update(command.name, command.breed, command.dog.getName(), command.dog.getBreed(), command.dog.getAge(), command.dog.getPhotohraph());
+		break;
+	case OperationType::Undo:
+		this->serv.undo();
+		break;
+	case OperationType::Redo:
+		this->serv.redo();
+		break;
+	}
+
+	uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+	CommandStats& stats = this->stats[static_cast<int>(command.type)];
+	stats.count++;
+	stats.total += elapsed;
+	stats.last = elapsed;
+	if (elapsed > stats.worst)
+		stats.worst = elapsed;
+
+	if (!this->refreshPending && this->scheduleRefresh)
+	{
+		this->refreshPending = true;
+		this->scheduleRefresh();
+	}
+}
+
+/// <summary>
+/// Tells the dispatcher the view refreshed, the next
+/// command that goes through makes a new refresh due
+/// </summary>
+void CommandDispatcher::refreshed()
+{
+	if (!this->refreshPending)
+		return;
+
+	this->refreshPending = false;
+	this->refreshes++;
+}
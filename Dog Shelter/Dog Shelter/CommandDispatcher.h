@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include "Service.h"
+
+// the time the commands of one type took to run
+struct CommandStats
+{
+	uint64_t count = 0;
+	uint64_t total = 0;
+	uint64_t worst = 0;
+	uint64_t last = 0;
+
+	double averageMicroseconds() const;
+};
+
+// Runs the commands of a view against the service one at a time, in the
+// order they were submitted, and asks the view to refresh once for every
+// command that changed the shelter before the refresh could happen
+class CommandDispatcher
+{
+private:
+	Service& serv;
+	std::deque<BatchOperation> queue;
+	bool running = false;
+
+	// called when a refresh becomes due, the view refreshes later and says so
+	std::function<void()> scheduleRefresh;
+	bool refreshPending = false;
+	uint64_t refreshes = 0;
+
+	CommandStats stats[OPERATION_TYPES];
+
+	void run(const BatchOperation& command);
+
+public:
+	CommandDispatcher(Service& serv) : serv{ serv } {}
+
+	void setRefreshScheduler(std::function<void()> schedule) { this->scheduleRefresh = std::move(schedule); }
+
+	void submit(const BatchOperation& command);
+	void refreshed();
+
+	bool isRefreshPending() const { return this->refreshPending; }
+	uint64_t getRefreshes() const { return this->refreshes; }
+	const CommandStats& getStats(const OperationType& type) const { return this->stats[static_cast<int>(type)]; }
+
+	static const char* nameOf(const OperationType& type);
+};
@@ -0,0 +1,52 @@
+#include <charconv>
+#include <string_view>
+#include "Config.h"
+
+uint64_t Config::pixmapCacheBytes = DEFAULT_PIXMAP_CACHE_MB * 1024ull * 1024;
+int Config::prefetchCount = DEFAULT_PREFETCH_COUNT;
+int Config::backupGenerations = DEFAULT_BACKUP_GENERATIONS;
+size_t Config::historyEntries = DEFAULT_HISTORY_ENTRIES;
+size_t Config::historyBytes = DEFAULT_HISTORY_KB * 1024;
+
+/// <summary>
+/// Parses the value of a numeric option
+/// </summary>
+/// <param name="argument">the command line argument</param>
+/// <param name="option">the option, including the equal sign</param>
+/// <param name="value">receives the value</param>
+/// <returns>true if the argument sets the option to a number,
+///			 false, otherwise</returns>
+static bool parseOption(std::string_view argument, std::string_view option, uint64_t& value)
+{
+	if (argument.substr(0, option.size()) != option)
+		return false;
+
+	argument.remove_prefix(option.size());
+	auto result = std::from_chars(argument.data(), argument.data() + argument.size(), value);
+	return result.ec == std::errc{} && result.ptr == argument.data() + argument.size();
+}
+
+/// <summary>
+/// Reads the settings given on the command line, unknown
+/// arguments and invalid values are ignored
+/// </summary>
+/// <param name="argc">the number of arguments</param>
+/// <param name="argv">the arguments</param>
+void Config::parse(int argc, char* argv[])
+{
+	uint64_t value = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (parseOption(argv[i], "--pixmap-cache-mb=", value))
+			pixmapCacheBytes = value * 1024 * 1024;
+		else if (parseOption(argv[i], "--prefetch-count=", value) && value <= 100)
+			prefetchCount = static_cast<int>(value);
+		else if (parseOption(argv[i], "--backup-generations=", value) && value <= 100)
+			backupGenerations = static_cast<int>(value);
+		else if (parseOption(argv[i], "--history-entries=", value) && value > 0)
+			historyEntries = static_cast<size_t>(value);
+		else if (parseOption(argv[i], "--history-kb=", value))
+			historyBytes = static_cast<size_t>(value * 1024);
+	}
+}
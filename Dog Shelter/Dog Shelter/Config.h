@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// budget of the decoded photographs kept in memory, in megabytes
+#define DEFAULT_PIXMAP_CACHE_MB 128
+// number of dogs whose photographs are fetched ahead while browsing
+#define DEFAULT_PREFETCH_COUNT 3
+// number of older generations of the repository file kept as backups
+#define DEFAULT_BACKUP_GENERATIONS 2
+// number of actions each of the undo and redo stacks keeps in memory
+#define DEFAULT_HISTORY_ENTRIES 256
+// memory each of the undo and redo stacks may take, in kilobytes
+#define DEFAULT_HISTORY_KB 256
+
+// Settings chosen at startup, they can be overridden on the command line:
+//   --pixmap-cache-mb=<megabytes>
+//   --prefetch-count=<dogs>
+//   --backup-generations=<count>
+//   --history-entries=<actions>
+//   --history-kb=<kilobytes>
+class Config
+{
+private:
+	static uint64_t pixmapCacheBytes;
+	static int prefetchCount;
+	static int backupGenerations;
+	static size_t historyEntries;
+	static size_t historyBytes;
+
+public:
+	static void parse(int argc, char* argv[]);
+
+	static uint64_t getPixmapCacheBytes() { return pixmapCacheBytes; }
+	static void setPixmapCacheBytes(const uint64_t& bytes) { pixmapCacheBytes = bytes; }
+
+	static int getPrefetchCount() { return prefetchCount; }
+	static void setPrefetchCount(const int& count) { prefetchCount = count; }
+
+	static int getBackupGenerations() { return backupGenerations; }
+	static void setBackupGenerations(const int& count) { backupGenerations = count; }
+
+	static size_t getHistoryEntries() { return historyEntries; }
+	static void setHistoryEntries(const size_t& entries) { historyEntries = entries; }
+	static size_t getHistoryBytes() { return historyBytes; }
+	static void setHistoryBytes(const size_t& bytes) { historyBytes = bytes; }
+};
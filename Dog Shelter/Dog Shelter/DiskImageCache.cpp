@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "DiskImageCache.h"
+
+/// <summary>
+/// Opens a cache directory, creating it if needed
+/// </summary>
+/// <param name="directory">the directory of the cache</param>
+/// <param name="maxBytes">the size of the images after which the least recently used are evicted</param>
+DiskImageCache::DiskImageCache(const std::string& directory, const uint64_t& maxBytes) : directory{ directory }, maxBytes{ maxBytes }
+{
+	std::error_code error;
+	std::filesystem::create_directories(this->directory, error);
+
+	this->scan();
+	this->trim();
+}
+
+/// <summary>
+/// Hashes an url into a file name (64 bit FNV-1a)
+/// </summary>
+/// <param name="url">the url</param>
+/// <returns>the hash as 16 hexadecimal digits</returns>
+std::string DiskImageCache::hashOf(const std::string& url)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (const char& c : url)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+
+	static const char digits[] = "0123456789abcdef";
+	std::string result(16, '0');
+	for (int i = 15; i >= 0; i--, hash >>= 4)
+		result[i] = digits[hash & 0xF];
+
+	return result;
+}
+
+std::string DiskImageCache::pathOf(const std::string& hash, const char* extension) const
+{
+	return (std::filesystem::path{ this->directory } / (hash + extension)).string();
+}
+
+/// <summary>
+/// Loads the entries left by previous runs, ordered by their last use
+/// </summary>
+void DiskImageCache::scan()
+{
+	std::vector<std::pair<std::filesystem::file_time_type, std::string>> found;
+	std::error_code error;
+
+	for (const auto& file : std::filesystem::directory_iterator{ this->directory, error })
+	{
+		if (file.path().extension() != ".meta")
+			continue;
+
+		std::string hash = file.path().stem().string();
+		std::string image = this->pathOf(hash, ".img");
+
+		Entry entry{};
+		std::ifstream meta(file.path());
+		if (!std::getline(meta, entry.url) || !std::filesystem::exists(image, error))
+		{
+			// an interrupted store, drop what is left of it
+			std::filesystem::remove(file.path(), error);
+			std::filesystem::remove(image, error);
+			continue;
+		}
+		std::getline(meta, entry.etag);
+		std::getline(meta, entry.lastModified);
+
+		entry.size = std::filesystem::file_size(image, error);
+		this->totalBytes += entry.size;
+		this->entries[hash] = entry;
+
+		found.emplace_back(std::filesystem::last_write_time(image, error), hash);
+	}
+
+	std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+	for (const auto& use : found)
+	{
+		this->uses.push_back(use.second);
+		this->entries[use.second].use = std::prev(this->uses.end());
+	}
+}
+
+/// <summary>
+/// Marks an entry as the most recently used one, in memory only,
+/// the file is marked by readImage
+/// </summary>
+void DiskImageCache::touch(Entry& entry)
+{
+	this->uses.splice(this->uses.begin(), this->uses, entry.use);
+}
+
+/// <summary>
+/// Deletes an entry and its files
+/// </summary>
+void DiskImageCache::evict(const std::string& hash)
+{
+	auto it = this->entries.find(hash);
+	if (it == this->entries.end())
+		return;
+
+	std::error_code error;
+	std::filesystem::remove(this->pathOf(hash, ".img"), error);
+	std::filesystem::remove(this->pathOf(hash, ".meta"), error);
+
+	this->totalBytes -= it->second.size;
+	this->uses.erase(it->second.use);
+	this->entries.erase(it);
+}
+
+/// <summary>
+/// Evicts the least recently used entries until the cache fits its size limit
+/// </summary>
+void DiskImageCache::trim()
+{
+	while (this->totalBytes > this->maxBytes && !this->uses.empty())
+		this->evict(this->uses.back());
+}
+
+/// <summary>
+/// Finds the file of the image of an url and marks it as used,
+/// only the index in memory is read, the disk is not touched
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="path">receives the file of the image, see readImage</param>
+/// <returns>true if the url is cached,
+///			 false, otherwise</returns>
+bool DiskImageCache::locate(const std::string& url, std::string& path)
+{
+	std::string hash = hashOf(url);
+	auto it = this->entries.find(hash);
+	if (it == this->entries.end() || it->second.url != url)
+		return false;
+
+	path = this->pathOf(hash, ".img");
+	this->touch(it->second);
+	return true;
+}
+
+/// <summary>
+/// Reads an image file found by locate, on any thread, and records
+/// the use in its modification time so the order survives restarts
+/// </summary>
+/// <param name="path">the file of the image</param>
+/// <param name="data">receives the bytes of the image</param>
+/// <returns>true if the file could be read,
+///			 false if it was evicted meanwhile</returns>
+bool DiskImageCache::readImage(const std::string& path, std::string& data)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::ostringstream buffer;
+	buffer << file.rdbuf();
+	data = buffer.str();
+	file.close();
+
+	std::error_code error;
+	std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+	return true;
+}
+
+/// <summary>
+/// Reads the image of an url
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="data">receives the bytes of the image</param>
+/// <returns>true if the url is cached,
+///			 false, otherwise</returns>
+bool DiskImageCache::lookup(const std::string& url, std::string& data)
+{
+	std::string path;
+	if (!this->locate(url, path))
+		return false;
+
+	if (!readImage(path, data))
+	{
+		this->remove(url);
+		return false;
+	}
+
+	return true;
+}
+
+/// <summary>
+/// Gets the validators to revalidate the image of an url with
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="etag">receives the ETag, empty if the server sent none</param>
+/// <param name="lastModified">receives the Last-Modified date, empty if the server sent none</param>
+/// <returns>true if the url is cached,
+///			 false, otherwise</returns>
+bool DiskImageCache::validators(const std::string& url, std::string& etag, std::string& lastModified) const
+{
+	auto it = this->entries.find(hashOf(url));
+	if (it == this->entries.end() || it->second.url != url)
+		return false;
+
+	etag = it->second.etag;
+	lastModified = it->second.lastModified;
+	return true;
+}
+
+/// <summary>
+/// Stores the image of an url, replacing the previous one
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="data">the bytes of the image</param>
+/// <param name="etag">the ETag sent by the server</param>
+/// <param name="lastModified">the Last-Modified date sent by the server</param>
+void DiskImageCache::store(const std::string& url, const std::string& data, const std::string& etag, const std::string& lastModified)
+{
+	std::string hash = hashOf(url);
+	this->evict(hash);
+
+	if (data.size() > this->maxBytes)
+		return;
+
+	// the image is complete before the meta file makes it visible
+	std::string image = this->pathOf(hash, ".img");
+	std::string temp = image + ".tmp";
+	{
+		std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+		if (!file.write(data.data(), static_cast<std::streamsize>(data.size())))
+			return;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temp, image, error);
+	if (error)
+	{
+		std::filesystem::remove(temp, error);
+		return;
+	}
+
+	std::ofstream meta(this->pathOf(hash, ".meta"), std::ios::trunc);
+	meta << url << '\n' << etag << '\n' << lastModified << '\n';
+	meta.close();
+
+	this->uses.push_front(hash);
+	this->entries[hash] = Entry{ url, etag, lastModified, data.size(), this->uses.begin() };
+	this->totalBytes += data.size();
+
+	this->trim();
+}
+
+/// <summary>
+/// Removes the image of an url
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+void DiskImageCache::remove(const std::string& url)
+{
+	std::string hash = hashOf(url);
+	auto it = this->entries.find(hash);
+	if (it != this->entries.end() && it->second.url == url)
+		this->evict(hash);
+}
+
+/// <summary>
+/// Decides which image to use after a request for an url, which
+/// was conditional if the cache had validators for it
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="response">the response of the server</param>
+/// <param name="data">receives the bytes of the image</param>
+/// <returns>where the image comes from, only an updated
+///			 image differs from the one already cached</returns>
+ImageResolution DiskImageCache::resolve(const std::string& url, const HttpResponse& response, std::string& data)
+{
+	if (response.status == 200 && !response.body.empty())
+	{
+		this->store(url, response.body, response.etag, response.lastModified);
+		data = response.body;
+		return ImageResolution::Updated;
+	}
+
+	// 304 Not Modified confirms the cached copy, on any other
+	// outcome, an empty body included, a stale copy beats no image
+	return this->lookup(url, data) ? ImageResolution::Cached : ImageResolution::Missing;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// directory and size limit of the photograph cache
+#define IMAGE_CACHE_DIRECTORY "ImageCache"
+#define IMAGE_CACHE_MAX_BYTES (256ull * 1024 * 1024)
+
+// the parts of an HTTP response the cache cares about,
+// a status of 0 means the request failed without a response
+struct HttpResponse
+{
+	int status = 0;
+	std::string body;
+	std::string etag;
+	std::string lastModified;
+};
+
+// the image to show for an url once its request is answered
+enum class ImageResolution
+{
+	// no image, neither from the server nor from the cache
+	Missing,
+	// the cached image is still the one to show
+	Cached,
+	// the server sent a new image
+	Updated
+};
+
+// Content addressed disk cache of downloaded photographs. Each url is
+// stored as <hash>.img next to a <hash>.meta file holding the url and
+// its validators, the modification time of the image is its last use.
+class DiskImageCache
+{
+private:
+	struct Entry
+	{
+		std::string url;
+		std::string etag;
+		std::string lastModified;
+		uint64_t size = 0;
+		std::list<std::string>::iterator use;
+	};
+
+	std::string directory;
+	uint64_t maxBytes;
+	uint64_t totalBytes = 0;
+
+	// hash -> entry, uses are ordered from the most to the least recent
+	std::unordered_map<std::string, Entry> entries;
+	std::list<std::string> uses;
+
+	static std::string hashOf(const std::string& url);
+	std::string pathOf(const std::string& hash, const char* extension) const;
+
+	void scan();
+	void touch(Entry& entry);
+	void evict(const std::string& hash);
+	void trim();
+
+public:
+	DiskImageCache(const std::string& directory = IMAGE_CACHE_DIRECTORY, const uint64_t& maxBytes = IMAGE_CACHE_MAX_BYTES);
+
+	bool lookup(const std::string& url, std::string& data);
+	bool locate(const std::string& url, std::string& path);
+	static bool readImage(const std::string& path, std::string& data);
+	bool validators(const std::string& url, std::string& etag, std::string& lastModified) const;
+	void store(const std::string& url, const std::string& data, const std::string& etag, const std::string& lastModified);
+	void remove(const std::string& url);
+
+	ImageResolution resolve(const std::string& url, const HttpResponse& response, std::string& data);
+
+	uint64_t size() const { return this->totalBytes; }
+	int count() const { return static_cast<int>(this->entries.size()); }
+};
@@ -1,8 +1,94 @@
 #include <iostream>
 #include <vector>
+#include <charconv>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 #include "Dog.h"
 #include "Utils.h"
 
+// the breeds live in the deque, which never moves them, the
+// index refers to their names; dogs are made on the persistence
+// and compaction threads as well, they mostly look breeds up
+struct BreedTable
+{
+	std::deque<Breed> breeds;
+	std::unordered_map<std::string_view, const Breed*> index;
+	std::shared_mutex mutex;
+};
+
+static BreedTable& breedTable()
+{
+	static BreedTable table;
+	return table;
+}
+
+/// <summary>
+/// Returns the shared copy of a breed, adding it if needed,
+/// a breed already known is found without any allocation
+/// </summary>
+/// <param name="breed">the breed</param>
+/// <returns>the interned breed, it lives as long as the program</returns>
+const Breed* BreedDictionary::intern(std::string_view breed)
+{
+	BreedTable& table = breedTable();
+
+	{
+		std::shared_lock<std::shared_mutex> lock{ table.mutex };
+		auto it = table.index.find(breed);
+		if (it != table.index.end())
+			return it->second;
+	}
+
+	std::unique_lock<std::shared_mutex> lock{ table.mutex };
+	auto it = table.index.find(breed);
+	if (it != table.index.end())
+		return it->second;
+
+	table.breeds.push_back(Breed{ std::string{ breed }, static_cast<BreedId>(table.breeds.size()) });
+	const Breed* added = &table.breeds.back();
+	table.index.emplace(added->name, added);
+
+	return added;
+}
+
+/// <summary>
+/// Looks up the id of a breed without adding it
+/// </summary>
+/// <param name="breed">the breed</param>
+/// <returns>the id of the breed, -1 if no dog ever had it</returns>
+int BreedDictionary::find(std::string_view breed)
+{
+	BreedTable& table = breedTable();
+
+	std::shared_lock<std::shared_mutex> lock{ table.mutex };
+	auto it = table.index.find(breed);
+	return it == table.index.end() ? -1 : static_cast<int>(it->second->id);
+}
+
+/// <summary>
+/// The empty breed of the default dogs, interned only once
+/// </summary>
+/// <returns>the empty breed</returns>
+const Breed* BreedDictionary::none()
+{
+	static const Breed* empty = intern("");
+	return empty;
+}
+
+/// <summary>
+/// The number of breeds seen so far
+/// </summary>
+/// <returns>the number of breeds</returns>
+int BreedDictionary::size()
+{
+	BreedTable& table = breedTable();
+
+	std::shared_lock<std::shared_mutex> lock{ table.mutex };
+	return static_cast<int>(table.breeds.size());
+}
+
 /// <summary>
 /// Constructs the Dog
 /// </summary>
@@ -11,7 +97,22 @@
 /// <param name="age">The age of the dog</param>
 /// <param name="photograph">The photograph of the dog</param>
 Dog::Dog(const std::string& name, const std::string& breed, const int& age, const std::string& photograph)
-	: name{ name }, breed{ breed }, age{ age }, photograph{ photograph }{}
+	: name{ name }, breed{ BreedDictionary::intern(breed) }, age{ age }, photograph{ photograph }{}
+
+/// <summary>
+/// Sets every field of the dog from views, reusing the existing buffers
+/// </summary>
+/// <param name="_name">The name of the dog</param>
+/// <param name="_breed">The breed of the dog</param>
+/// <param name="_age">The age of the dog</param>
+/// <param name="_photograph">The photograph of the dog</param>
+void Dog::assign(std::string_view _name, std::string_view _breed, const int& _age, std::string_view _photograph)
+{
+	this->name.assign(_name);
+	this->breed = BreedDictionary::intern(_breed);
+	this->age = _age;
+	this->photograph.assign(_photograph);
+}
 
 /// <summary>
 /// Lists the information of the dog
@@ -19,10 +120,42 @@ Dog::Dog(const std::string& name, const std::string& breed, const int& age, cons
 /// <returns>the string representation of the dog</returns>
 std::string Dog::toString() const
 {
-	std::string text = this->name + " is a " + this->breed + " of age " + std::to_string(this->age);
+	std::string text = this->name + " is a " + this->breed->name + " of age " + std::to_string(this->age);
 	return text;
 }
 
+/// <summary>
+/// Reads the dog from a line of the text file, the strings
+/// are copied straight from the line without tokenizing it;
+/// the id is optional so files written before it still load
+/// </summary>
+/// <param name="line">the line holding the comma separated fields</param>
+/// <returns>true if the line holds a valid dog,
+///			 false, otherwise</returns>
+bool Dog::parse(std::string_view line)
+{
+	std::string_view fields[5];
+	uint64_t _id = 0;
+
+	if (splitFields(line, ',', fields, 5))
+	{
+		auto result = std::from_chars(fields[4].data(), fields[4].data() + fields[4].size(), _id);
+		if (result.ec != std::errc{} || result.ptr != fields[4].data() + fields[4].size())
+			return false;
+	}
+	else if (!splitFields(line, ',', fields, 4))
+		return false;
+
+	int value = 0;
+	auto result = std::from_chars(fields[2].data(), fields[2].data() + fields[2].size(), value);
+	if (result.ec != std::errc{})
+		return false;
+
+	this->assign(fields[0], fields[1], value, fields[3]);
+	this->id = _id;
+	return true;
+}
+
 /// <summary>
 /// Overrides the >> operator
 /// </summary>
@@ -37,13 +170,14 @@ std::istream& operator>>(std::istream& stream, Dog& dog)
 	std::vector<std::string> tokens = tokenize(line, ',');
 	if (tokens.size() != 4)
 	{
-		dog.name = dog.breed = dog.photograph = "null";
+		dog.name = dog.photograph = "null";
+		dog.breed = BreedDictionary::intern("null");
 		dog.age = -32768;
 		return stream;
 	}
 
 	dog.name = tokens[0];
-	dog.breed = tokens[1];
+	dog.breed = BreedDictionary::intern(tokens[1]);
 	dog.age = std::stoi(tokens[2]);
 	dog.photograph = tokens[3];
 
@@ -58,6 +192,6 @@ std::istream& operator>>(std::istream& stream, Dog& dog)
 /// <returns>a reference to the stream</returns>
 std::ostream& operator<<(std::ostream& stream, const Dog& dog)
 {
-	stream << dog.name << "," << dog.breed << "," << dog.age << "," << dog.photograph << std::endl;
+	stream << dog.name << "," << dog.breed->name << "," << dog.age << "," << dog.photograph << '\n';
 	return stream;
 }
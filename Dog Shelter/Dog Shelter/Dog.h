@@ -1,33 +1,66 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <cstdint>
+
+typedef uint32_t BreedId;
+
+// a breed as stored by the BreedDictionary
+struct Breed
+{
+	std::string name;
+	BreedId id;
+};
+
+// The breeds of all the dogs, each one stored once: a dog points to its
+// breed here instead of owning a copy, so two dogs of the same breed
+// share it and compare their breeds by address. The ids number the
+// breeds from 0 in the order they are first seen. There are only a few
+// hundred breeds, they are never removed.
+class BreedDictionary
+{
+public:
+	static const Breed* intern(std::string_view breed);
+	static int find(std::string_view breed);
+	static const Breed* none();
+	static int size();
+};
 
 class Dog
 {
 private:
 	std::string name;
-	std::string breed;
+	const Breed* breed;
 	int age;
 	std::string photograph;
+	// assigned by the repository holding the dog, 0 until then,
+	// it stays the same when the dog is renamed
+	uint64_t id = 0;
 
 public:
-	Dog() : name{ "" }, breed{ "" }, age{ -1 }, photograph{ "" }{}
+	Dog() : name{ "" }, breed{ BreedDictionary::none() }, age{ -1 }, photograph{ "" }{}
 	Dog(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
 
-	std::string getName() const { return this->name; }
-	std::string getBreed() const { return this->breed; }
+	const std::string& getName() const { return this->name; }
+	const std::string& getBreed() const { return this->breed->name; }
+	BreedId getBreedId() const { return this->breed->id; }
 	int getAge() const { return this->age; }
-	std::string getPhotohraph() const { return this->photograph; }
+	const std::string& getPhotohraph() const { return this->photograph; }
+	uint64_t getId() const { return this->id; }
 
 	void setName(const std::string& _name) { this->name = _name; }
-	void setBreed(const std::string& _breed) { this->breed = _breed; }
+	void setBreed(const std::string& _breed) { this->breed = BreedDictionary::intern(_breed); }
 	void setAge(const int& _age) { this->age = _age; }
 	void setPhotograph(const std::string& _photograph) { this->photograph = _photograph; }
+	void setId(const uint64_t& _id) { this->id = _id; }
+	void assign(std::string_view _name, std::string_view _breed, const int& _age, std::string_view _photograph);
 
 	std::string toString() const;
+	bool parse(std::string_view line);
 
-	bool operator==(const Dog& dog) const { return this->name == dog.name && this->breed == dog.breed; };
+	bool operator==(const Dog& dog) const { return this->breed == dog.breed && this->name == dog.name; };
 	friend std::istream& operator>>(std::istream& stream, Dog& dog);
 	friend std::ostream& operator<<(std::ostream& stream, const Dog& dog);
 };
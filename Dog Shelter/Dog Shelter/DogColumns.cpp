@@ -0,0 +1,104 @@
+#include <limits>
+#include "DogColumns.h"
+
+/// <summary>
+/// Stores an age in a single byte, ages that do not fit
+/// saturate and are checked against the dog when filtering
+/// </summary>
+/// <param name="age">the age of the dog</param>
+/// <returns>the stored age</returns>
+int8_t DogColumns::compactAge(const int& age)
+{
+	if (age > std::numeric_limits<int8_t>::max())
+		return std::numeric_limits<int8_t>::max();
+	if (age < std::numeric_limits<int8_t>::min())
+		return std::numeric_limits<int8_t>::min();
+
+	return static_cast<int8_t>(age);
+}
+
+/// <summary>
+/// Inserts the fields of a dog at a position
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="dog">the dog</param>
+void DogColumns::insert(const int& index, const Dog& dog)
+{
+	this->breedColumn.insert(this->breedColumn.begin() + index, dog.getBreedId());
+	this->ageColumn.insert(this->ageColumn.begin() + index, compactAge(dog.getAge()));
+}
+
+/// <summary>
+/// Erases the fields of the dog at a position
+/// </summary>
+/// <param name="index">the position of the dog</param>
+void DogColumns::erase(const int& index)
+{
+	this->breedColumn.erase(this->breedColumn.begin() + index);
+	this->ageColumn.erase(this->ageColumn.begin() + index);
+}
+
+/// <summary>
+/// Replaces the fields of the dog at a position
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="dog">the new dog</param>
+void DogColumns::assign(const int& index, const Dog& dog)
+{
+	this->breedColumn[index] = dog.getBreedId();
+	this->ageColumn[index] = compactAge(dog.getAge());
+}
+
+/// <summary>
+/// Reserves room for a number of dogs
+/// </summary>
+/// <param name="count">the number of dogs</param>
+void DogColumns::reserve(const size_t& count)
+{
+	this->breedColumn.reserve(count);
+	this->ageColumn.reserve(count);
+}
+
+/// <summary>
+/// Removes every dog, the breed dictionary is kept
+/// </summary>
+void DogColumns::clear()
+{
+	this->breedColumn.clear();
+	this->ageColumn.clear();
+}
+
+/// <summary>
+/// Finds the dogs of a breed younger than an age by
+/// scanning the integer columns instead of the strings
+/// </summary>
+/// <param name="breed">the breed to filter by, empty for any breed</param>
+/// <param name="age">the exclusive upper bound of the age</param>
+/// <param name="dogs">the dogs the columns describe</param>
+/// <returns>the positions of the matching dogs</returns>
+std::vector<int> DogColumns::filterByBreedAndAge(const std::string& breed, const int& age, const std::vector<Dog>& dogs) const
+{
+	std::vector<int> result;
+
+	int id = breed.empty() ? -1 : BreedDictionary::find(breed);
+	if (!breed.empty() && id == -1)
+		return result;
+
+	// the exact age is only needed when the bound or the stored age saturate
+	int8_t bound = compactAge(age);
+	bool exactBound = bound == age;
+
+	for (int i = 0; i < this->size(); i++)
+	{
+		if (id != -1 && this->breedColumn[i] != static_cast<BreedId>(id))
+			continue;
+
+		int8_t stored = this->ageColumn[i];
+		bool saturated = stored == std::numeric_limits<int8_t>::max() || stored == std::numeric_limits<int8_t>::min();
+
+		if (exactBound && !saturated ? stored < bound : dogs[i].getAge() < age)
+			result.push_back(i);
+	}
+
+	return result;
+}
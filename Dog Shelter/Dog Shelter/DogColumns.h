@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Dog.h"
+
+// Column store of the fields the shelter is filtered by, kept position
+// by position in sync with the dogs of a repository: the ids of the
+// interned breeds and the ages in a byte each, so a filter scans a few
+// bytes per dog instead of the dogs themselves
+class DogColumns
+{
+private:
+	std::vector<BreedId> breedColumn;
+	std::vector<int8_t> ageColumn;
+
+	static int8_t compactAge(const int& age);
+
+public:
+	void insert(const int& index, const Dog& dog);
+	void erase(const int& index);
+	void assign(const int& index, const Dog& dog);
+	void reserve(const size_t& count);
+	void clear();
+
+	std::vector<int> filterByBreedAndAge(const std::string& breed, const int& age, const std::vector<Dog>& dogs) const;
+
+	int size() const { return static_cast<int>(this->ageColumn.size()); }
+};
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include "DogListModel.h"
+
+DogListModel::DogListModel(Repository& repo, QObject* parent) : QAbstractListModel{ parent }, repo{ repo }, font{ "Arial", 14 }
+{
+	this->repo.addObserver(this);
+}
+
+DogListModel::~DogListModel()
+{
+	this->repo.removeObserver(this);
+}
+
+int DogListModel::rowCount(const QModelIndex& parent) const
+{
+	if (parent.isValid())
+		return 0;
+
+	return this->filtered ? static_cast<int>(this->positions.size()) : this->repo.size();
+}
+
+QVariant DogListModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= this->rowCount())
+		return QVariant{};
+
+	if (role == Qt::DisplayRole)
+	{
+		const Dog& dog = this->repo[this->positionOf(index.row())];
+		return QString::fromStdString(dog.getName() + " - " + dog.getBreed());
+	}
+	if (role == Qt::FontRole)
+		return this->font;
+
+	return QVariant{};
+}
+
+void DogListModel::showAll()
+{
+	this->beginResetModel();
+	this->filtered = false;
+	this->positions.clear();
+	this->endResetModel();
+}
+
+void DogListModel::showPositions(const std::vector<int>& positions)
+{
+	this->beginResetModel();
+	this->filtered = true;
+	this->positions = positions;
+	this->endResetModel();
+}
+
+int DogListModel::positionOf(const int& row) const
+{
+	return this->filtered ? this->positions[row] : row;
+}
+
+// the shown positions are sorted, so the row of a position is found by binary search
+int DogListModel::rowOf(const int& position) const
+{
+	if (!this->filtered)
+		return position;
+
+	auto it = std::lower_bound(this->positions.begin(), this->positions.end(), position);
+	if (it == this->positions.end() || *it != position)
+		return -1;
+
+	return static_cast<int>(it - this->positions.begin());
+}
+
+void DogListModel::beforeInsert(const int& index)
+{
+	if (!this->filtered)
+		this->beginInsertRows(QModelIndex{}, index, index);
+}
+
+void DogListModel::afterInsert(const int& index)
+{
+	if (!this->filtered)
+	{
+		this->endInsertRows();
+		return;
+	}
+
+	// a new dog only shows up once the filter runs again, the others move down
+	for (int& position : this->positions)
+		if (position >= index)
+			position++;
+}
+
+void DogListModel::beforeRemove(const int& index)
+{
+	int row = this->rowOf(index);
+	if (row != -1)
+		this->beginRemoveRows(QModelIndex{}, row, row);
+}
+
+void DogListModel::afterRemove(const int& index)
+{
+	if (!this->filtered)
+	{
+		this->endRemoveRows();
+		return;
+	}
+
+	int row = this->rowOf(index);
+	if (row != -1)
+		this->positions.erase(this->positions.begin() + row);
+
+	for (int& position : this->positions)
+		if (position > index)
+			position--;
+
+	if (row != -1)
+		this->endRemoveRows();
+}
+
+void DogListModel::afterUpdate(const int& index)
+{
+	int row = this->rowOf(index);
+	if (row == -1)
+		return;
+
+	QModelIndex changed = this->index(row);
+	emit dataChanged(changed, changed, { Qt::DisplayRole });
+}
+
+void DogListModel::beforeReset()
+{
+	this->beginResetModel();
+}
+
+void DogListModel::afterReset()
+{
+	// the positions of the filtered dogs are meaningless after a sort
+	this->filtered = false;
+	this->positions.clear();
+	this->endResetModel();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFont>
+#include "Repository.h"
+#include "Observer.h"
+
+// List model over the dogs of a repository or over a subset of their
+// positions, rows are only materialized when the view asks for them
+class DogListModel : public QAbstractListModel, public Observer
+{
+private:
+	Repository& repo;
+	QFont font;
+
+	// the shown positions, only used when filtered
+	std::vector<int> positions;
+	bool filtered = false;
+
+	int rowOf(const int& position) const;
+
+public:
+	DogListModel(Repository& repo, QObject* parent = Q_NULLPTR);
+	~DogListModel();
+
+	// number of rows
+	int rowCount(const QModelIndex& parent = QModelIndex{}) const override;
+
+	// Value at a given position
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+	// show every dog or only the ones at the given positions
+	void showAll();
+	void showPositions(const std::vector<int>& positions);
+	bool isFiltered() const { return this->filtered; }
+
+	// position in the repository of the dog on a row
+	int positionOf(const int& row) const;
+
+	// repository changes
+	void beforeInsert(const int& index) override;
+	void afterInsert(const int& index) override;
+	void beforeRemove(const int& index) override;
+	void afterRemove(const int& index) override;
+	void afterUpdate(const int& index) override;
+	void beforeReset() override;
+	void afterReset() override;
+};
@@ -0,0 +1,103 @@
+#include <algorithm>
+#include "DogView.h"
+#include "Validator.h"
+
+/// <summary>
+/// Constructs a view of every dog of a repository
+/// </summary>
+/// <param name="repo">the repository, it has to outlive the view</param>
+DogView::DogView(const Repository& repo) : repo{ &repo }
+{
+	this->ids.reserve(repo.size());
+	for (const Dog& dog : repo.getDogs())
+		this->ids.push_back(dog.getId());
+}
+
+/// <summary>
+/// Constructs a view of some of the dogs of a repository
+/// </summary>
+/// <param name="repo">the repository, it has to outlive the view</param>
+/// <param name="positions">the positions of the dogs in the repository, in the order of the view</param>
+DogView::DogView(const Repository& repo, const std::vector<int>& positions) : repo{ &repo }
+{
+	this->ids.reserve(positions.size());
+	for (const int& position : positions)
+		this->ids.push_back(repo[position].getId());
+}
+
+/// <summary>
+/// Returns a dog of the view, straight from the repository
+/// </summary>
+/// <param name="index">the position of the dog in the view</param>
+/// <returns>the dog</returns>
+const Dog& DogView::operator[](const int& index) const
+{
+	return this->repo->findById(this->ids[index]);
+}
+
+/// <summary>
+/// returns the position of a dog in the view
+/// </summary>
+/// <param name="dog">the dog to look for</param>
+/// <returns>the position of the dog,
+///			 -1 if the dog is not in the view</returns>
+int DogView::indexOf(const Dog& dog) const
+{
+	if (this->repo == nullptr)
+		return -1;
+
+	// a dog made outside of the repository is known by its name
+	uint64_t id = dog.getId();
+	if (id == 0)
+	{
+		int position = this->repo->indexOf(dog);
+		if (position == -1)
+			return -1;
+		id = (*this->repo)[position].getId();
+	}
+
+	auto it = std::find(this->ids.begin(), this->ids.end(), id);
+	return it == this->ids.end() ? -1 : static_cast<int>(it - this->ids.begin());
+}
+
+/// <summary>
+/// Puts a dog of the repository in the view
+/// </summary>
+/// <param name="dog">the dog, it has to be in the repository</param>
+/// <param name="index">the position of the dog in the view, appended if invalid</param>
+void DogView::insert(const Dog& dog, int index)
+{
+	int position = this->repo == nullptr ? -1 : this->repo->indexOf(dog);
+	if (position == -1)
+		throw InexistenDogException{};
+
+	if (index < 0 || index > this->size()) index = this->size();
+	this->ids.insert(this->ids.begin() + index, (*this->repo)[position].getId());
+}
+
+/// <summary>
+/// Takes a dog out of the view, the repository keeps it
+/// </summary>
+/// <param name="dog">the dog to take out</param>
+void DogView::remove(const Dog& dog)
+{
+	this->removeAt(-1, dog);
+}
+
+/// <summary>
+/// Takes the dog found at a known position out of the view,
+/// the position is only a hint, as for Repository::removeAt
+/// </summary>
+/// <param name="index">where the dog is expected to be, -1 if unknown</param>
+/// <param name="dog">the dog to take out</param>
+void DogView::removeAt(const int& index, const Dog& dog)
+{
+	int position = index;
+	if (dog.getId() == 0 || index < 0 || index >= this->size() || this->ids[index] != dog.getId())
+		position = this->indexOf(dog);
+
+	if (position == -1)
+		throw InexistenDogException{};
+
+	this->ids.erase(this->ids.begin() + position);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "Dog.h"
+#include "Repository.h"
+
+// Some of the dogs of a repository, in order, kept as their ids: the dogs
+// are not copied and the view stays valid while other dogs are added,
+// removed or renamed, a dog removed from the repository has to leave the
+// view as well before it is read
+class DogView
+{
+private:
+	const Repository* repo = nullptr;
+	std::vector<uint64_t> ids;
+
+public:
+	class Iterator
+	{
+	private:
+		const DogView* view;
+		int index;
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef Dog value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const Dog* pointer;
+		typedef const Dog& reference;
+
+		Iterator(const DogView* view, const int& index) : view{ view }, index{ index } {}
+
+		const Dog& operator*() const { return (*this->view)[this->index]; }
+		const Dog* operator->() const { return &(*this->view)[this->index]; }
+		Iterator& operator++() { this->index++; return *this; }
+		Iterator operator++(int) { Iterator old = *this; this->index++; return old; }
+
+		bool operator==(const Iterator& other) const { return this->index == other.index; }
+		bool operator!=(const Iterator& other) const { return this->index != other.index; }
+	};
+
+	DogView() = default;
+	DogView(const Repository& repo);
+	DogView(const Repository& repo, const std::vector<int>& positions);
+
+	int size() const { return static_cast<int>(this->ids.size()); }
+	const Dog& operator[](const int& index) const;
+	uint64_t idAt(const int& index) const { return this->ids[index]; }
+	int indexOf(const Dog& dog) const;
+
+	void insert(const Dog& dog, int index = -1);
+	void remove(const Dog& dog);
+	void removeAt(const int& index, const Dog& dog);
+	void clear() { this->ids.clear(); }
+
+	Iterator begin() const { return Iterator{ this, 0 }; }
+	Iterator end() const { return Iterator{ this, this->size() }; }
+};
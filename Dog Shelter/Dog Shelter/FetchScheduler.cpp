@@ -0,0 +1,124 @@
+#include <limits>
+#include "FetchScheduler.h"
+
+std::tuple<int, uint64_t, std::string> FetchScheduler::waitingKey(const std::string& url, const Request& request) const
+{
+	// the newest request has the smallest key among the ones of its priority
+	return { static_cast<int>(request.priority), std::numeric_limits<uint64_t>::max() - request.order, url };
+}
+
+/// <summary>
+/// Requests the download of an url
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <param name="priority">the priority of the download</param>
+/// <returns>true if the url was not requested yet,
+///			 false if it already was, its priority is raised if needed</returns>
+bool FetchScheduler::enqueue(const std::string& url, const FetchPriority& priority)
+{
+	auto it = this->requests.find(url);
+	if (it == this->requests.end())
+	{
+		Request request{ priority, this->counter++, false };
+		this->requests.emplace(url, request);
+		this->waiting.insert(this->waitingKey(url, request));
+		return true;
+	}
+
+	Request& request = it->second;
+	if (priority < request.priority)
+	{
+		if (!request.running)
+			this->waiting.erase(this->waitingKey(url, request));
+
+		request.priority = priority;
+		request.order = this->counter++;
+
+		if (!request.running)
+			this->waiting.insert(this->waitingKey(url, request));
+	}
+
+	return false;
+}
+
+/// <summary>
+/// Starts the waiting downloads that fit under the concurrency limit
+/// </summary>
+/// <returns>the urls to download now</returns>
+std::vector<std::string> FetchScheduler::start()
+{
+	std::vector<std::string> started;
+
+	while (this->running < this->maxRunning && !this->waiting.empty())
+	{
+		std::string url = std::get<2>(*this->waiting.begin());
+		this->waiting.erase(this->waiting.begin());
+
+		this->requests[url].running = true;
+		this->running++;
+		started.push_back(url);
+	}
+
+	return started;
+}
+
+/// <summary>
+/// Marks the download of an url as done, unknown urls are ignored
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+void FetchScheduler::finished(const std::string& url)
+{
+	auto it = this->requests.find(url);
+	if (it == this->requests.end() || !it->second.running)
+		return;
+
+	this->running--;
+	this->requests.erase(it);
+}
+
+/// <summary>
+/// Drops the request of an url
+/// </summary>
+/// <param name="url">the url of the photograph</param>
+/// <returns>true if the download was running and has to be aborted,
+///			 false, otherwise</returns>
+bool FetchScheduler::cancel(const std::string& url)
+{
+	auto it = this->requests.find(url);
+	if (it == this->requests.end())
+		return false;
+
+	bool wasRunning = it->second.running;
+	if (wasRunning)
+		this->running--;
+	else
+		this->waiting.erase(this->waitingKey(url, it->second));
+
+	this->requests.erase(it);
+	return wasRunning;
+}
+
+/// <summary>
+/// Drops the requests of a priority whose url is not kept
+/// </summary>
+/// <param name="priority">the priority of the requests to drop</param>
+/// <param name="keep">the urls that are still needed</param>
+/// <returns>the urls of the dropped downloads that were running</returns>
+std::vector<std::string> FetchScheduler::cancelOthers(const FetchPriority& priority, const std::unordered_set<std::string>& keep)
+{
+	std::vector<std::string> dropped;
+	for (const auto& request : this->requests)
+	{
+		if (request.second.priority == priority && keep.find(request.first) == keep.end())
+			dropped.push_back(request.first);
+	}
+
+	std::vector<std::string> aborted;
+	for (const std::string& url : dropped)
+	{
+		if (this->cancel(url))
+			aborted.push_back(url);
+	}
+
+	return aborted;
+}
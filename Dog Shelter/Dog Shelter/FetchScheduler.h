@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// number of photographs downloaded at the same time
+#define MAX_CONCURRENT_FETCHES 6
+
+// the photograph of the dog on screen comes first, then the rows
+// visible in the adoption table, then the ones fetched ahead of time
+enum class FetchPriority
+{
+	Foreground,
+	Visible,
+	Prefetch
+};
+
+// Decides which photograph downloads run: every url is requested at
+// most once at a time, at most a fixed number of them run together and
+// the waiting ones start by priority, the most recent request first.
+class FetchScheduler
+{
+private:
+	struct Request
+	{
+		FetchPriority priority;
+		uint64_t order;
+		bool running;
+	};
+
+	int maxRunning;
+	int running = 0;
+	uint64_t counter = 0;
+
+	std::unordered_map<std::string, Request> requests;
+	// (priority, newest first, url) of the waiting requests
+	std::set<std::tuple<int, uint64_t, std::string>> waiting;
+
+	std::tuple<int, uint64_t, std::string> waitingKey(const std::string& url, const Request& request) const;
+
+public:
+	FetchScheduler(const int& maxRunning = MAX_CONCURRENT_FETCHES) : maxRunning{ maxRunning } {}
+
+	bool enqueue(const std::string& url, const FetchPriority& priority);
+	std::vector<std::string> start();
+	void finished(const std::string& url);
+
+	bool cancel(const std::string& url);
+	std::vector<std::string> cancelOthers(const FetchPriority& priority, const std::unordered_set<std::string>& keep);
+
+	bool isRequested(const std::string& url) const { return this->requests.find(url) != this->requests.end(); }
+	int getRunning() const { return this->running; }
+	int getWaiting() const { return static_cast<int>(this->waiting.size()); }
+};
@@ -0,0 +1,243 @@
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include "FileUtils.h"
+#include "Utils.h"
+#include "Validator.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+/// Ends the data with the checksum line
+/// </summary>
+/// <param name="data">the contents of a file</param>
+void FileUtils::appendChecksum(std::string& data)
+{
+	char line[FILE_CHECKSUM_SIZE + 1];
+	std::snprintf(line, sizeof(line), FILE_CHECKSUM_TAG "%08x\n", static_cast<unsigned int>(crc32(data)));
+	data.append(line, FILE_CHECKSUM_SIZE);
+}
+
+/// <summary>
+/// Checks the checksum line at the end of the data
+/// </summary>
+/// <param name="data">the contents of a file</param>
+/// <param name="body">receives the data without the checksum line</param>
+/// <returns>Valid if the checksum matches, Invalid if it does not,
+///			 Missing if the file has no checksum line</returns>
+ChecksumStatus FileUtils::verifyChecksum(std::string_view data, std::string_view& body)
+{
+	body = data;
+
+	std::string_view tag{ FILE_CHECKSUM_TAG };
+	if (data.size() < FILE_CHECKSUM_SIZE || data.back() != '\n')
+		return ChecksumStatus::Missing;
+
+	std::string_view line = data.substr(data.size() - FILE_CHECKSUM_SIZE);
+	if (line.substr(0, tag.size()) != tag)
+		return ChecksumStatus::Missing;
+
+	uint32_t expected = 0;
+	for (char c : line.substr(tag.size(), 8))
+	{
+		int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+		if (digit == -1)
+			return ChecksumStatus::Invalid;
+
+		expected = expected << 4 | static_cast<uint32_t>(digit);
+	}
+
+	body = data.substr(0, data.size() - FILE_CHECKSUM_SIZE);
+	return crc32(body) == expected ? ChecksumStatus::Valid : ChecksumStatus::Invalid;
+}
+
+/// <summary>
+/// Gets the name of an older generation of a file
+/// </summary>
+/// <param name="path">the file</param>
+/// <param name="generation">the generation, 1 is the newest backup</param>
+/// <returns>the name of the backup</returns>
+std::string FileUtils::backupName(const std::string& path, const int& generation)
+{
+	return path + "." + std::to_string(generation);
+}
+
+// writes the data and waits until the disk has it
+void FileUtils::writeSynced(const std::string& path, std::string_view data)
+{
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		throw FileException("The file could not be opened!");
+
+	const char* next = data.data();
+	size_t left = data.size();
+	bool written = true;
+	while (left > 0 && written)
+	{
+		DWORD chunk = left > 0x40000000 ? 0x40000000 : static_cast<DWORD>(left);
+		DWORD count = 0;
+		written = WriteFile(handle, next, chunk, &count, nullptr) != 0;
+		next += count;
+		left -= count;
+	}
+
+	bool synced = written && FlushFileBuffers(handle) != 0;
+	CloseHandle(handle);
+#else
+	int descriptor = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (descriptor == -1)
+		throw FileException("The file could not be opened!");
+
+	const char* next = data.data();
+	size_t left = data.size();
+	bool written = true;
+	while (left > 0 && written)
+	{
+		ssize_t count = ::write(descriptor, next, left);
+		written = count > 0;
+		if (written)
+		{
+			next += count;
+			left -= static_cast<size_t>(count);
+		}
+	}
+
+	bool synced = written && fsync(descriptor) == 0;
+	close(descriptor);
+#endif
+
+	if (!synced)
+		throw FileException("The file could not be written!");
+}
+
+// renames a file over another one and makes the rename durable
+void FileUtils::replaceFile(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+	if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		throw FileException("The file could not be replaced!");
+#else
+	if (std::rename(from.c_str(), to.c_str()) != 0)
+		throw FileException("The file could not be replaced!");
+
+	// the new directory entry is on the disk once the directory is synced
+	std::string directory = std::filesystem::path{ to }.parent_path().string();
+	int descriptor = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+	if (descriptor != -1)
+	{
+		fsync(descriptor);
+		close(descriptor);
+	}
+#endif
+}
+
+// gives a file a second name as a backup, the file itself stays in place;
+// a hard link where the file system has them, a synced copy otherwise
+void FileUtils::backupFile(const std::string& path, const std::string& backup)
+{
+	std::string temp = backup + ".tmp";
+	std::error_code error;
+	std::filesystem::remove(temp, error);
+
+	std::filesystem::create_hard_link(path, temp, error);
+	if (error)
+	{
+		std::ifstream f(path, std::ios::binary);
+		if (!f.is_open())
+			throw FileException("The file could not be backed up!");
+
+		std::string data{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+		f.close();
+		writeSynced(temp, data);
+	}
+
+	replaceFile(temp, backup);
+}
+
+/// <summary>
+/// Replaces a file with new content so that a crash leaves
+/// either the old or the new file, never a partial one
+/// </summary>
+/// <param name="path">the file to replace</param>
+/// <param name="data">the new content</param>
+/// <param name="backups">the number of older generations to keep</param>
+void FileUtils::writeDurably(const std::string& path, std::string_view data, const int& backups)
+{
+	std::string temp = path + ".tmp";
+	writeSynced(temp, data);
+
+	std::error_code error;
+	if (backups > 0 && std::filesystem::exists(path, error))
+	{
+		// the oldest generation drops out, the current file becomes the newest one
+		for (int generation = backups - 1; generation >= 1; generation--)
+		{
+			if (std::filesystem::exists(backupName(path, generation), error))
+				replaceFile(backupName(path, generation), backupName(path, generation + 1));
+		}
+
+		// the file keeps its name until the new one is renamed over it,
+		// so a crash at any point leaves a file in place
+		backupFile(path, backupName(path, 1));
+	}
+
+	replaceFile(temp, path);
+}
+
+// a missing or empty file counts as damaged
+ChecksumStatus FileUtils::status(const std::string& path)
+{
+	std::ifstream f(path, std::ios::binary);
+	if (!f.is_open())
+		return ChecksumStatus::Invalid;
+
+	std::string data{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+	if (data.empty())
+		return ChecksumStatus::Invalid;
+
+	std::string_view body;
+	return verifyChecksum(data, body);
+}
+
+/// <summary>
+/// Puts back the newest valid generation of a file that is missing,
+/// empty or fails its checksum. A file without a checksum is kept
+/// unless a backup has one, then it is a checksummed file cut short.
+/// </summary>
+/// <param name="path">the file to check</param>
+/// <returns>true if the file was recovered from a backup,
+///			 false, otherwise</returns>
+bool FileUtils::recover(const std::string& path)
+{
+	ChecksumStatus current = status(path);
+	if (current == ChecksumStatus::Valid)
+		return false;
+
+	std::error_code error;
+	for (int generation = 1; std::filesystem::exists(backupName(path, generation), error); generation++)
+	{
+		// a backup without a checksum is only better than a damaged file
+		ChecksumStatus backup = status(backupName(path, generation));
+		if (backup != ChecksumStatus::Valid && (backup == ChecksumStatus::Invalid || current == ChecksumStatus::Missing))
+			continue;
+
+		// the backup is kept, a copy takes the place of the damaged file
+		std::ifstream f(backupName(path, generation), std::ios::binary);
+		std::string data{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+		f.close();
+
+		writeDurably(path, data);
+		return true;
+	}
+
+	return false;
+}
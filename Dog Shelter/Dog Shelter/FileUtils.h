@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// the last line of a checksummed file: the tag and the CRC32 of
+// everything before the line as 8 hex digits
+#define FILE_CHECKSUM_TAG "#crc32 "
+#define FILE_CHECKSUM_SIZE 16
+
+enum class ChecksumStatus
+{
+	Valid,
+	Missing,
+	Invalid
+};
+
+// Durable file replacement: the new content is written to a temporary
+// file, synced to the disk and renamed over the old file, so a crash
+// leaves either the old or the new file. The older generations can be
+// kept as <name>.1, <name>.2 and so on; the current file is linked (or
+// copied) to <name>.1 before the new one takes its name, so the name is
+// never left without a file. A damaged file is recovered from the newest
+// generation whose checksum is still valid.
+class FileUtils
+{
+private:
+	static void writeSynced(const std::string& path, std::string_view data);
+	static void replaceFile(const std::string& from, const std::string& to);
+	static void backupFile(const std::string& path, const std::string& backup);
+	static ChecksumStatus status(const std::string& path);
+
+public:
+	static void appendChecksum(std::string& data);
+	static ChecksumStatus verifyChecksum(std::string_view data, std::string_view& body);
+
+	static std::string backupName(const std::string& path, const int& generation);
+	static void writeDurably(const std::string& path, std::string_view data, const int& backups = 0);
+	static bool recover(const std::string& path);
+};
@@ -0,0 +1,49 @@
+#include "FrameStats.h"
+
+/// <summary>
+/// Starts a frame, a frame already started goes on
+/// </summary>
+void FrameStats::beginFrame()
+{
+	if (this->inFrame)
+		return;
+
+	this->inFrame = true;
+	this->current = 0;
+}
+
+/// <summary>
+/// Adds the time of one paint to the current frame,
+/// paints outside of a frame are not counted
+/// </summary>
+/// <param name="nanoseconds">the time the paint took</param>
+void FrameStats::add(const uint64_t& nanoseconds)
+{
+	if (this->inFrame)
+		this->current += nanoseconds;
+}
+
+/// <summary>
+/// Ends the current frame and adds it to the totals
+/// </summary>
+void FrameStats::endFrame()
+{
+	if (!this->inFrame)
+		return;
+
+	this->inFrame = false;
+	this->frames++;
+	this->total += this->current;
+	this->last = this->current;
+	if (this->current > this->worst)
+		this->worst = this->current;
+}
+
+/// <summary>
+/// The average paint time of a frame
+/// </summary>
+/// <returns>the average in microseconds, 0 if there were no frames</returns>
+double FrameStats::averageMicroseconds() const
+{
+	return this->frames == 0 ? 0.0 : static_cast<double>(this->total) / this->frames / 1000.0;
+}
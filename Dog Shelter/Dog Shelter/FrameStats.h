@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// Adds up the time spent painting during each frame of a view
+// and keeps the totals over all the frames
+class FrameStats
+{
+private:
+	bool inFrame = false;
+	uint64_t current = 0;
+
+	uint64_t frames = 0;
+	uint64_t total = 0;
+	uint64_t worst = 0;
+	uint64_t last = 0;
+
+public:
+	void beginFrame();
+	void add(const uint64_t& nanoseconds);
+	void endFrame();
+
+	bool isInFrame() const { return this->inFrame; }
+
+	uint64_t getFrames() const { return this->frames; }
+	uint64_t getLast() const { return this->last; }
+	uint64_t getWorst() const { return this->worst; }
+	double averageMicroseconds() const;
+};
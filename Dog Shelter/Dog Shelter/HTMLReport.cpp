@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include "HTMLReport.h"
+#include "FileUtils.h"
+#include "Validator.h"
+
+static const char REPORT_HEADER[] = "<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>Adoption List</title></head><body>"
+	"<table border=\"1\" cellpadding=\"5\" cellspacing=\"5\"><tr><th>Name</th><th>Breed</th><th>Age</th><th>Photograph</th></tr>";
+static const char REPORT_FOOTER[] = "</table>";
+static const char REPORT_END[] = "</body></html>";
+
+// the markup around the fields of one row
+static const size_t ROW_MARKUP = 64;
+
+// the characters with a special meaning in HTML text and attributes
+static const std::array<bool, 256> SPECIAL = []()
+{
+	std::array<bool, 256> special{};
+	special['&'] = special['<'] = special['>'] = special['"'] = special['\''] = true;
+	return special;
+}();
+
+// pages link to each other from the same directory
+static std::string_view linkName(std::string_view fileName)
+{
+	return fileName.substr(fileName.find_last_of("/\\") + 1);
+}
+
+/// <summary>
+/// Creates a report, nothing is written yet
+/// </summary>
+/// <param name="baseName">the name of the first page without the extension</param>
+/// <param name="pageSize">the number of dogs on a page</param>
+HTMLReport::HTMLReport(const std::string& baseName, const int& pageSize) : baseName{ baseName }, pageSize{ pageSize > 0 ? pageSize : 1 }
+{
+}
+
+/// <summary>
+/// Appends text to a buffer escaping it in one pass, the scan skips
+/// ahead to the next special character and the run before it is
+/// appended as a whole, text without any is appended at once
+/// </summary>
+/// <param name="buffer">the buffer receiving the text</param>
+/// <param name="text">the text to escape</param>
+void HTMLReport::escape(std::string& buffer, std::string_view text)
+{
+	const char* run = text.data();
+	const char* end = run + text.size();
+
+	while (true)
+	{
+		const char* special = std::find_if(run, end, [](const char& c) { return SPECIAL[static_cast<unsigned char>(c)]; });
+		buffer.append(run, special - run);
+		if (special == end)
+			return;
+
+		switch (*special)
+		{
+		case '&': buffer.append("&amp;"); break;
+		case '<': buffer.append("&lt;"); break;
+		case '>': buffer.append("&gt;"); break;
+		case '"': buffer.append("&quot;"); break;
+		default: buffer.append("&#39;"); break;
+		}
+		run = special + 1;
+	}
+}
+
+/// <summary>
+/// Gets the file name of a page
+/// </summary>
+/// <param name="page">the page, starting from 0</param>
+/// <returns>the file name of the page</returns>
+std::string HTMLReport::pageName(const int& page) const
+{
+	if (page == 0)
+		return this->baseName + ".html";
+
+	return this->baseName + "-" + std::to_string(page + 1) + ".html";
+}
+
+/// <summary>
+/// Marks the page of a dog changed in place
+/// </summary>
+/// <param name="index">the position of the dog</param>
+void HTMLReport::changed(const int& index)
+{
+	this->dirty.insert(index / this->pageSize);
+}
+
+/// <summary>
+/// Marks the pages moved by a dog added or removed,
+/// from the page of the dog to the last one
+/// </summary>
+/// <param name="index">the position of the dog</param>
+void HTMLReport::shifted(const int& index)
+{
+	this->markFrom(index / this->pageSize);
+}
+
+/// <summary>
+/// Marks every page
+/// </summary>
+void HTMLReport::invalidate()
+{
+	this->markFrom(0);
+}
+
+void HTMLReport::markFrom(const int& page)
+{
+	if (this->dirtyFrom == -1 || page < this->dirtyFrom)
+		this->dirtyFrom = page;
+}
+
+/// <summary>
+/// Writes the dirty pages of the report, and the pages whose links
+/// change when the number of pages does, the pages past the last
+/// one are deleted
+/// </summary>
+/// <param name="dogs">every dog of the report</param>
+void HTMLReport::write(const std::vector<Dog>& dogs)
+{
+	int count = static_cast<int>(dogs.size());
+	int pages = count == 0 ? 1 : (count + this->pageSize - 1) / this->pageSize;
+
+	if (this->pages == -1)
+		this->markFrom(0);
+	else if (pages != this->pages)
+		// the old last page gains or loses the link to the next one
+		this->markFrom((pages < this->pages ? pages : this->pages) - 1);
+
+	for (int page = 0; page < pages; page++)
+	{
+		bool isDirty = (this->dirtyFrom != -1 && page >= this->dirtyFrom) || this->dirty.count(page) != 0;
+		if (!isDirty)
+			continue;
+
+		this->renderPage(dogs, page, pages);
+		this->pagesWritten++;
+
+		if (this->worker != nullptr)
+		{
+			this->worker->replace(this->pageName(page), [page = this->buffer]() { return page; });
+			continue;
+		}
+
+		FileUtils::writeDurably(this->pageName(page), this->buffer);
+	}
+
+	// the first write does not know how many pages an earlier run
+	// left behind, the ones after the last page are stale
+	int stale = this->pages;
+	if (stale == -1)
+	{
+		stale = pages;
+		while (std::filesystem::exists(this->pageName(stale)))
+			stale++;
+	}
+
+	for (int page = pages; page < stale; page++)
+	{
+		if (this->worker != nullptr)
+			this->worker->remove(this->pageName(page));
+		else
+			std::remove(this->pageName(page).c_str());
+	}
+
+	this->pages = pages;
+	this->dirty.clear();
+	this->dirtyFrom = -1;
+}
+
+void HTMLReport::renderPage(const std::vector<Dog>& dogs, const int& page, const int& pages)
+{
+	size_t first = static_cast<size_t>(page) * this->pageSize;
+	size_t last = first + this->pageSize < dogs.size() ? first + this->pageSize : dogs.size();
+
+	// room for the whole page, so the buffer grows at most once
+	size_t size = sizeof(REPORT_HEADER) + sizeof(REPORT_FOOTER) + sizeof(REPORT_END) + 2 * this->baseName.size() + 128;
+	for (size_t i = first; i < last; i++)
+		size += ROW_MARKUP + dogs[i].getName().size() + dogs[i].getBreed().size() + 2 * dogs[i].getPhotohraph().size();
+
+	this->buffer.clear();
+	this->buffer.reserve(size + size / 8);
+
+	this->buffer.append(REPORT_HEADER);
+	for (size_t i = first; i < last; i++)
+	{
+		const Dog& dog = dogs[i];
+		// the digits of any int, its sign and one more for the last digit
+		char age[std::numeric_limits<int>::digits10 + 3];
+		std::to_chars_result converted = std::to_chars(age, age + sizeof(age), dog.getAge());
+		if (converted.ec != std::errc{})
+			throw FileException("The report could not be written!");
+		char* end = converted.ptr;
+
+		this->buffer.append("<tr><td>");
+		escape(this->buffer, dog.getName());
+		this->buffer.append("</td><td>");
+		escape(this->buffer, dog.getBreed());
+		this->buffer.append("</td><td>");
+		this->buffer.append(age, end - age);
+		this->buffer.append("</td><td><a href=\"");
+		escape(this->buffer, dog.getPhotohraph());
+		this->buffer.append("\">link</a></td></tr>");
+	}
+	this->buffer.append(REPORT_FOOTER);
+
+	if (pages > 1)
+	{
+		this->buffer.append("<p>");
+		if (page > 0)
+		{
+			this->buffer.append("<a href=\"");
+			escape(this->buffer, linkName(this->pageName(page - 1)));
+			this->buffer.append("\">previous</a> ");
+		}
+		this->buffer.append("page ").append(std::to_string(page + 1));
+		if (page < pages - 1)
+		{
+			this->buffer.append(" <a href=\"");
+			escape(this->buffer, linkName(this->pageName(page + 1)));
+			this->buffer.append("\">next</a>");
+		}
+		this->buffer.append("</p>");
+	}
+	this->buffer.append(REPORT_END);
+}
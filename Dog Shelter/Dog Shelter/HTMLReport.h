@@ -0,0 +1,52 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Dog.h"
+#include "PersistenceWorker.h"
+
+// number of dogs on one page of the HTML report
+#define HTML_REPORT_PAGE_SIZE 1000
+
+// Writes the dogs as an HTML table split into pages of a fixed number of
+// rows. The first page is <name>.html, the next ones <name>-2.html and so
+// on, each page links to its neighbours. A page is rendered into one
+// reused buffer and written at once, and only the pages touched by the
+// changes since the last write are written again.
+class HTMLReport
+{
+private:
+	std::string baseName;
+	int pageSize;
+
+	// the number of pages on disk, -1 before the first write
+	int pages = -1;
+	std::set<int> dirty;
+	// every page from this one on is dirty
+	int dirtyFrom = -1;
+
+	std::string buffer;
+	int pagesWritten = 0;
+	PersistenceWorker* worker = nullptr;
+
+	void renderPage(const std::vector<Dog>& dogs, const int& page, const int& pages);
+	void markFrom(const int& page);
+
+public:
+	HTMLReport(const std::string& baseName, const int& pageSize = HTML_REPORT_PAGE_SIZE);
+
+	static void escape(std::string& buffer, std::string_view text);
+	std::string pageName(const int& page) const;
+
+	void changed(const int& index);
+	void shifted(const int& index);
+	void invalidate();
+	void write(const std::vector<Dog>& dogs);
+
+	void setPersistenceWorker(PersistenceWorker* worker) { this->worker = worker; }
+
+	int getPages() const { return this->pages; }
+	int getPagesWritten() const { return this->pagesWritten; }
+};
@@ -0,0 +1,152 @@
+#include <filesystem>
+#include <fstream>
+#include "History.h"
+#include "Validator.h"
+
+/// <summary>
+/// Deletes the log, it only means something to this run
+/// </summary>
+History::SpillLog::~SpillLog()
+{
+	this->clear();
+}
+
+/// <summary>
+/// Appends an encoded action to the log
+/// </summary>
+/// <param name="record">the encoded action</param>
+void History::SpillLog::push(const std::string& record)
+{
+	// a log left by an earlier run is overwritten by the first record
+	std::ofstream f(this->fileName, std::ios::binary | (this->offsets.empty() ? std::ios::trunc : std::ios::app));
+	if (!f.is_open())
+		throw FileException("The history could not be saved!");
+
+	uint64_t offset = this->offsets.empty() ? 0 : static_cast<uint64_t>(std::filesystem::file_size(this->fileName));
+	f.write(record.data(), static_cast<std::streamsize>(record.size()));
+	f.close();
+
+	this->offsets.push_back(offset);
+}
+
+/// <summary>
+/// Removes the newest encoded action from the log
+/// </summary>
+/// <returns>the encoded action</returns>
+std::string History::SpillLog::pop()
+{
+	uint64_t offset = this->offsets.back();
+	uint64_t end = std::filesystem::file_size(this->fileName);
+
+	std::ifstream f(this->fileName, std::ios::binary);
+	if (!f.is_open())
+		throw FileException("The history could not be read!");
+
+	std::string record(static_cast<size_t>(end - offset), '\0');
+	f.seekg(static_cast<std::streamoff>(offset));
+	f.read(&record[0], static_cast<std::streamsize>(record.size()));
+	f.close();
+
+	this->offsets.pop_back();
+	if (this->offsets.empty())
+		std::filesystem::remove(this->fileName);
+	else
+		std::filesystem::resize_file(this->fileName, offset);
+
+	return record;
+}
+
+/// <summary>
+/// Empties the log and deletes its file
+/// </summary>
+void History::SpillLog::clear()
+{
+	if (this->offsets.empty())
+		return;
+
+	this->offsets.clear();
+	std::error_code error;
+	std::filesystem::remove(this->fileName, error);
+}
+
+/// <summary>
+/// Creates an empty history
+/// </summary>
+/// <param name="context">what the spilled actions work on once they are read back</param>
+/// <param name="logName">the base name of the spill logs</param>
+/// <param name="maxEntries">the number of actions a stack keeps in memory</param>
+/// <param name="maxBytes">the memory a stack may take</param>
+History::History(const ActionContext& context, const std::string& logName, const size_t& maxEntries, const size_t& maxBytes)
+	: context{ context }, maxEntries{ maxEntries > 0 ? maxEntries : 1 }, maxBytes{ maxBytes },
+	undoStack{ logName + ".undo" }, redoStack{ logName + ".redo" }
+{
+}
+
+/// <summary>
+/// Records a new action, the actions that could be redone are dropped
+/// </summary>
+/// <param name="action">the action that was just done</param>
+void History::record(std::unique_ptr<Action> action)
+{
+	this->clear(this->redoStack);
+	this->push(this->undoStack, std::move(action));
+}
+
+/// <summary>
+/// Drops every action
+/// </summary>
+void History::clear()
+{
+	this->clear(this->undoStack);
+	this->clear(this->redoStack);
+}
+
+void History::clear(Stack& stack)
+{
+	stack.actions.clear();
+	stack.bytes = 0;
+	stack.log.clear();
+}
+
+void History::push(Stack& stack, std::unique_ptr<Action> action)
+{
+	stack.bytes += action->size();
+	stack.actions.push_back(std::move(action));
+
+	// the newest action always stays in memory
+	while (stack.actions.size() > 1 && (stack.actions.size() > this->maxEntries || stack.bytes > this->maxBytes))
+	{
+		std::unique_ptr<Action>& oldest = stack.actions.front();
+
+		std::string record;
+		oldest->encode(record);
+		stack.log.push(record);
+
+		stack.bytes -= oldest->size();
+		stack.actions.pop_front();
+	}
+}
+
+std::unique_ptr<Action> History::take(Stack& stack)
+{
+	// the spilled actions come back once the ones in memory are used up
+	if (stack.actions.empty() && stack.log.size() > 0)
+	{
+		std::string record = stack.log.pop();
+		std::string_view data{ record };
+
+		std::unique_ptr<Action> action = Action::decode(data, this->context);
+		if (action == nullptr)
+			throw FileException("The history is corrupted!");
+
+		return action;
+	}
+
+	if (stack.actions.empty())
+		return nullptr;
+
+	std::unique_ptr<Action> action = std::move(stack.actions.back());
+	stack.actions.pop_back();
+	stack.bytes -= action->size();
+	return action;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Action.h"
+
+// The undo and redo stacks of a window. Each stack keeps its newest
+// actions in memory within a budget of entries and bytes; the oldest
+// ones are encoded and spilled to a log file used as a stack on disk,
+// and come back into memory when the stack gets down to them.
+class History
+{
+private:
+	// a stack of encoded actions in a file, the newest at the end
+	class SpillLog
+	{
+	private:
+		std::string fileName;
+		std::vector<uint64_t> offsets;
+
+	public:
+		SpillLog(const std::string& fileName) : fileName{ fileName } {}
+		~SpillLog();
+
+		void push(const std::string& record);
+		std::string pop();
+		void clear();
+
+		size_t size() const { return this->offsets.size(); }
+	};
+
+	struct Stack
+	{
+		std::deque<std::unique_ptr<Action>> actions;
+		size_t bytes = 0;
+		SpillLog log;
+
+		Stack(const std::string& fileName) : log{ fileName } {}
+	};
+
+	ActionContext context;
+	size_t maxEntries;
+	size_t maxBytes;
+
+	Stack undoStack;
+	Stack redoStack;
+
+	void push(Stack& stack, std::unique_ptr<Action> action);
+	std::unique_ptr<Action> take(Stack& stack);
+	void clear(Stack& stack);
+
+public:
+	History(const ActionContext& context, const std::string& logName, const size_t& maxEntries, const size_t& maxBytes);
+
+	History(const History&) = delete;
+	History& operator=(const History&) = delete;
+
+	void record(std::unique_ptr<Action> action);
+	std::unique_ptr<Action> takeUndo() { return this->take(this->undoStack); }
+	std::unique_ptr<Action> takeRedo() { return this->take(this->redoStack); }
+	void pushUndo(std::unique_ptr<Action> action) { this->push(this->undoStack, std::move(action)); }
+	void pushRedo(std::unique_ptr<Action> action) { this->push(this->redoStack, std::move(action)); }
+	void clear();
+
+	bool canUndo() const { return !this->undoStack.actions.empty() || this->undoStack.log.size() > 0; }
+	bool canRedo() const { return !this->redoStack.actions.empty() || this->redoStack.log.size() > 0; }
+
+	size_t getBytes() const { return this->undoStack.bytes + this->redoStack.bytes; }
+	size_t getEntries() const { return this->undoStack.actions.size() + this->redoStack.actions.size(); }
+	size_t getSpilled() const { return this->undoStack.log.size() + this->redoStack.log.size(); }
+};
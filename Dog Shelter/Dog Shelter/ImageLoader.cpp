@@ -0,0 +1,259 @@
+#include <QtNetwork/QNetworkReply>
+#include "ImageLoader.h"
+
+// the memory a pixmap takes
+static size_t pixmapBytes(const QPixmap& pixmap)
+{
+	return static_cast<size_t>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+ImageLoader::ImageLoader(const uint64_t& memoryBudget, QObject* parent) : QObject{ parent }, images{ static_cast<size_t>(memoryBudget), pixmapBytes }
+{
+	this->networkManager = new QNetworkAccessManager{ this };
+	QObject::connect(this->networkManager, &QNetworkAccessManager::finished, this, &ImageLoader::receivedReply);
+}
+
+ImageLoader::~ImageLoader()
+{
+	// the workers post their results to this object
+	this->decodePool.waitForDone();
+}
+
+QString ImageLoader::thumbnailKey(const QString& url, const QSize& size, const ImageFit& fit, const qreal& devicePixelRatio)
+{
+	return QString("%1x%2@%3%4 %5").arg(size.width()).arg(size.height()).arg(devicePixelRatio)
+		.arg(fit == ImageFit::Crop ? "c" : "s").arg(url);
+}
+
+// runs on the workers
+QImage ImageLoader::scale(const QImage& image, const Thumbnail& thumbnail)
+{
+	// the thumbnail is made in device pixels and keeps its logical size
+	int width = qRound(thumbnail.size.width() * thumbnail.devicePixelRatio);
+	int height = qRound(thumbnail.size.height() * thumbnail.devicePixelRatio);
+
+	QImage result;
+	if (image.isNull())
+	{
+		result = QImage{ width, height, QImage::Format_ARGB32_Premultiplied };
+		result.fill(Qt::black);
+	}
+	else if (thumbnail.fit == ImageFit::Stretch)
+	{
+		result = image.scaled(width, height, Qt::AspectRatioMode::IgnoreAspectRatio, Qt::TransformationMode::SmoothTransformation);
+	}
+	else
+	{
+		QImage scaled = image.scaled(width, height, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::TransformationMode::SmoothTransformation);
+		result = scaled.copy((scaled.width() - width) / 2, (scaled.height() - height) / 2, width, height);
+	}
+
+	result.setDevicePixelRatio(thumbnail.devicePixelRatio);
+	return result;
+}
+
+const QPixmap* ImageLoader::find(const QString& url, const QSize& size, const ImageFit& fit, const qreal& devicePixelRatio)
+{
+	return this->images.find(thumbnailKey(url, size, fit, devicePixelRatio));
+}
+
+void ImageLoader::request(const QString& url, const QSize& size, const ImageFit& fit, const FetchPriority& priority,
+	const qreal& devicePixelRatio)
+{
+	QString thumbnailKey = ImageLoader::thumbnailKey(url, size, fit, devicePixelRatio);
+	if (this->images.peek(thumbnailKey) != nullptr || size.isEmpty())
+		return;
+
+	Thumbnail thumbnail{ size, fit, devicePixelRatio };
+	std::string key = url.toStdString();
+
+	if (this->decoding.find(thumbnailKey) != this->decoding.end())
+		return;
+
+	// a warm start shows the image from the disk without waiting for the server,
+	// only the index is checked here, the file is read on the decode pool
+	std::string path;
+	bool cached = this->diskCache.locate(key, path);
+	if (cached)
+		this->decodeFile(url, path, thumbnail, thumbnailKey, priority);
+
+	// the server already confirmed the copy on the disk, a copy that
+	// left the disk since then is downloaded again like a new one
+	if (this->revalidated.find(url) != this->revalidated.end())
+	{
+		if (cached)
+			return;
+		this->revalidated.erase(url);
+	}
+
+	// the sizes to make once the download is in, a download
+	// already on its way only gets the more urgent priority
+	this->thumbnails[url].emplace(thumbnailKey, thumbnail);
+	this->scheduler.enqueue(key, priority);
+	this->startFetches();
+}
+
+void ImageLoader::retain(const std::vector<QString>& urls, const FetchPriority& priority)
+{
+	std::unordered_set<std::string> keep;
+	for (const QString& url : urls)
+		keep.insert(url.toStdString());
+
+	// the rows scrolled out of view, or the dogs browsed past,
+	// do not need their photographs any more
+	for (const std::string& key : this->scheduler.cancelOthers(priority, keep))
+	{
+		QString url = QString::fromStdString(key);
+		this->thumbnails.erase(url);
+
+		auto it = this->replies.find(url);
+		if (it == this->replies.end())
+			continue;
+
+		QNetworkReply* reply = it->second;
+		this->replies.erase(it);
+		reply->abort();
+	}
+
+	this->startFetches();
+}
+
+void ImageLoader::startFetches()
+{
+	for (const std::string& key : this->scheduler.start())
+	{
+		QString url = QString::fromStdString(key);
+
+		// ask the server to send the image only if it changed
+		QNetworkRequest request{ QUrl{ url } };
+		std::string etag, lastModified;
+		if (this->diskCache.validators(key, etag, lastModified))
+		{
+			if (!etag.empty())
+				request.setRawHeader("If-None-Match", QByteArray::fromStdString(etag));
+			if (!lastModified.empty())
+				request.setRawHeader("If-Modified-Since", QByteArray::fromStdString(lastModified));
+		}
+
+		this->replies[url] = this->networkManager->get(request);
+	}
+}
+
+std::vector<std::pair<QString, QImage>> ImageLoader::scaleAll(const QByteArray& bytes, const std::map<QString, Thumbnail>& wanted)
+{
+	// decode once, scale once per thumbnail
+	QImage image{};
+	image.loadFromData(bytes);
+	if (!image.isNull())
+		image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+	std::vector<std::pair<QString, QImage>> results;
+	for (const auto& thumbnail : wanted)
+		results.emplace_back(thumbnail.first, scale(image, thumbnail.second));
+	return results;
+}
+
+void ImageLoader::decode(const QString& url, const std::string& data, const std::map<QString, Thumbnail>& wanted)
+{
+	for (const auto& thumbnail : wanted)
+		this->decoding.insert(thumbnail.first);
+
+	QByteArray bytes = QByteArray::fromStdString(data);
+
+	// the pixmaps are made back on the GUI thread
+	this->decodePool.start([this, url, bytes, wanted]()
+		{
+			std::vector<std::pair<QString, QImage>> results = scaleAll(bytes, wanted);
+			QMetaObject::invokeMethod(this, [this, url, results]() { this->decoded(url, results); }, Qt::QueuedConnection);
+		});
+}
+
+void ImageLoader::decodeFile(const QString& url, const std::string& path, const Thumbnail& thumbnail, const QString& thumbnailKey,
+	const FetchPriority& priority)
+{
+	this->decoding.insert(thumbnailKey);
+
+	this->decodePool.start([this, url, path, thumbnail, thumbnailKey, priority]()
+		{
+			std::string data;
+			if (DiskImageCache::readImage(path, data))
+			{
+				std::vector<std::pair<QString, QImage>> results = scaleAll(QByteArray::fromStdString(data), { { thumbnailKey, thumbnail } });
+				QMetaObject::invokeMethod(this, [this, url, results]() { this->decoded(url, results); }, Qt::QueuedConnection);
+				return;
+			}
+
+			// the file left the disk after the index was checked,
+			// forget the copy and download the image like a new one
+			QMetaObject::invokeMethod(this, [this, url, thumbnail, thumbnailKey, priority]()
+				{
+					this->diskCache.remove(url.toStdString());
+					this->decoding.erase(thumbnailKey);
+					this->revalidated.erase(url);
+					this->request(url, thumbnail.size, thumbnail.fit, priority, thumbnail.devicePixelRatio);
+				}, Qt::QueuedConnection);
+		});
+}
+
+void ImageLoader::decoded(const QString& url, const std::vector<std::pair<QString, QImage>>& results)
+{
+	for (const auto& result : results)
+	{
+		this->images.insert(result.first, QPixmap::fromImage(result.second));
+		this->decoding.erase(result.first);
+	}
+
+	emit imageLoaded(url);
+}
+
+void ImageLoader::receivedReply(QNetworkReply* reply)
+{
+	// key by the requested url, the reply url changes on redirects
+	QString url = reply->request().url().toString();
+	std::string key = url.toStdString();
+
+	// a cancelled download leaves the url free to be requested again
+	if (reply->error() == QNetworkReply::OperationCanceledError)
+	{
+		reply->deleteLater();
+		this->startFetches();
+		return;
+	}
+
+	auto it = this->replies.find(url);
+	if (it != this->replies.end() && it->second == reply)
+		this->replies.erase(it);
+	this->scheduler.finished(key);
+
+	HttpResponse response{};
+	if (reply->error() == QNetworkReply::NoError)
+	{
+		response.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+		response.body = reply->readAll().toStdString();
+		response.etag = reply->rawHeader("ETag").toStdString();
+		response.lastModified = reply->rawHeader("Last-Modified").toStdString();
+	}
+
+	this->revalidated.insert(url);
+
+	// the sizes wanted from this download are made now, a later
+	// request of the url starts over with the sizes it asks for
+	std::map<QString, Thumbnail> wanted;
+	auto thumbnail = this->thumbnails.find(url);
+	if (thumbnail != this->thumbnails.end())
+	{
+		wanted = std::move(thumbnail->second);
+		this->thumbnails.erase(thumbnail);
+	}
+
+	// a cached copy was already decoded when the image was requested,
+	// only a new image or a missing one needs new thumbnails
+	std::string data;
+	ImageResolution resolution = this->diskCache.resolve(key, response, data);
+
+	if (resolution != ImageResolution::Cached && !wanted.empty())
+		this->decode(url, data, wanted);
+
+	reply->deleteLater();
+	this->startFetches();
+}
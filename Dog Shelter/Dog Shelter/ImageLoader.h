@@ -0,0 +1,89 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <QObject>
+#include <QPixmap>
+#include <QImage>
+#include <QThreadPool>
+#include <QtNetwork/QNetworkAccessManager>
+#include "DiskImageCache.h"
+#include "LRUCache.h"
+#include "FetchScheduler.h"
+
+// how a photograph is fitted into a thumbnail: cropped to keep its
+// aspect ratio or stretched over the whole thumbnail
+enum class ImageFit
+{
+	Crop,
+	Stretch
+};
+
+// Loads the photographs of the dogs for every view, from memory, from
+// the disk cache or from the network, in this order. Cached images are
+// shown right away and revalidated with the server once per run.
+// Downloads go through a FetchScheduler, so each url is fetched once
+// at a time and only a few of them run together. The photographs are
+// decoded and scaled on a thread pool, only the finished thumbnails,
+// one per url, size, fit and device pixel ratio, are kept as pixmaps.
+// A thumbnail has as many pixels as the screen shows, so it is drawn
+// without any scaling.
+class ImageLoader : public QObject
+{
+	Q_OBJECT
+
+public:
+	ImageLoader(const uint64_t& memoryBudget, QObject* parent = Q_NULLPTR);
+	~ImageLoader();
+
+	const QPixmap* find(const QString& url, const QSize& size, const ImageFit& fit, const qreal& devicePixelRatio = 1.0);
+	void request(const QString& url, const QSize& size, const ImageFit& fit, const FetchPriority& priority = FetchPriority::Visible,
+		const qreal& devicePixelRatio = 1.0);
+	void retain(const std::vector<QString>& urls, const FetchPriority& priority);
+
+	const LRUCache<QString, QPixmap>& getMemoryCache() const { return this->images; }
+	// the key of a thumbnail in the memory cache
+	static QString thumbnailKey(const QString& url, const QSize& size, const ImageFit& fit, const qreal& devicePixelRatio);
+
+private:
+	struct Thumbnail
+	{
+		QSize size;
+		ImageFit fit;
+		qreal devicePixelRatio;
+	};
+
+	QNetworkAccessManager* networkManager;
+	QThreadPool decodePool;
+	DiskImageCache diskCache;
+
+	// thumbnail key -> pixmap, see thumbnailKey
+	LRUCache<QString, QPixmap> images;
+
+	FetchScheduler scheduler;
+	std::unordered_map<QString, QNetworkReply*> replies;
+
+	// urls already checked with the server
+	std::unordered_set<QString> revalidated;
+	// the thumbnails waiting for the download of each url, the entry goes
+	// once the download is in or cancelled, and the ones being decoded
+	std::unordered_map<QString, std::map<QString, Thumbnail>> thumbnails;
+	std::unordered_set<QString> decoding;
+
+	static QImage scale(const QImage& image, const Thumbnail& thumbnail);
+	static std::vector<std::pair<QString, QImage>> scaleAll(const QByteArray& bytes, const std::map<QString, Thumbnail>& wanted);
+
+	void startFetches();
+	void decode(const QString& url, const std::string& data, const std::map<QString, Thumbnail>& wanted);
+	void decodeFile(const QString& url, const std::string& path, const Thumbnail& thumbnail, const QString& thumbnailKey,
+		const FetchPriority& priority);
+	void decoded(const QString& url, const std::vector<std::pair<QString, QImage>>& results);
+
+signals:
+	void imageLoaded(const QString& url);
+
+private slots:
+	void receivedReply(QNetworkReply* reply);
+};
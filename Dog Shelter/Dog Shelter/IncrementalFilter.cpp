@@ -0,0 +1,42 @@
+#include <algorithm>
+#include "IncrementalFilter.h"
+#include "Utils.h"
+
+/// <summary>
+/// Filters the dogs whose name or breed contains a text
+/// </summary>
+/// <param name="text">the text to filter by, empty for every dog</param>
+/// <returns>the positions of the matching dogs in the repository</returns>
+const std::vector<int>& IncrementalFilter::filter(const std::string& text)
+{
+	// every dog matching the new text also matches the old one,
+	// so the old matches are the only candidates while the repo is unchanged
+	bool refine = this->valid && this->version == this->repo.getVersion() &&
+		text.compare(0, this->query.size(), this->query) == 0;
+
+	if (refine)
+	{
+		this->lastScanned = static_cast<int>(this->matches.size());
+
+		if (text.size() != this->query.size())
+		{
+			auto end = std::remove_if(this->matches.begin(), this->matches.end(), [this, &text](const int& index)
+				{
+					const Dog& dog = this->repo[index];
+					return !contains(dog.getName(), text, false) && !contains(dog.getBreed(), text, false);
+				});
+			this->matches.erase(end, this->matches.end());
+		}
+	}
+	else
+	{
+		this->lastScanned = this->repo.size();
+		this->matches = this->repo.search(text);
+	}
+
+	this->query = text;
+	this->version = this->repo.getVersion();
+	this->valid = true;
+
+	return this->matches;
+}
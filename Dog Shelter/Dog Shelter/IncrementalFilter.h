@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "Repository.h"
+
+// delay between the last keystroke and running the filter
+#define FILTER_DEBOUNCE_MS 150
+
+// Filters the dogs of a repository by name or breed, refining the previous
+// result when the new query extends the previous one
+class IncrementalFilter
+{
+private:
+	const Repository& repo;
+
+	std::string query;
+	std::vector<int> matches;
+	uint64_t version = 0;
+	bool valid = false;
+	int lastScanned = 0;
+
+public:
+	IncrementalFilter(const Repository& repo) : repo{ repo } {}
+
+	const std::vector<int>& filter(const std::string& text);
+	void invalidate() { this->valid = false; }
+
+	const std::vector<int>& getMatches() const { return this->matches; }
+	int getLastScanned() const { return this->lastScanned; }
+};
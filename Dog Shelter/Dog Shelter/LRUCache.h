@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+// Cache that keeps the total size of its values under a byte budget by
+// evicting the least recently used ones. The newest value is never
+// evicted, so a value larger than the whole budget is still kept alone.
+template <class K, class V>
+class LRUCache
+{
+private:
+	struct Entry
+	{
+		V value;
+		size_t bytes;
+		typename std::list<K>::iterator use;
+	};
+
+	// key -> entry, uses are ordered from the most to the least recent
+	std::unordered_map<K, Entry> entries;
+	std::list<K> uses;
+	std::function<size_t(const V&)> sizeOf;
+
+	size_t budget;
+	size_t used = 0;
+
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+
+	void trim()
+	{
+		while (this->used > this->budget && this->uses.size() > 1)
+		{
+			auto it = this->entries.find(this->uses.back());
+			this->used -= it->second.bytes;
+			this->entries.erase(it);
+			this->uses.pop_back();
+			this->evictions++;
+		}
+	}
+
+public:
+	LRUCache(const size_t& budget, std::function<size_t(const V&)> sizeOf) : sizeOf{ std::move(sizeOf) }, budget{ budget } {}
+
+	/// <summary>
+	/// Finds a value and marks it as the most recently used one
+	/// </summary>
+	/// <param name="key">the key of the value</param>
+	/// <returns>the value, nullptr if it is not cached</returns>
+	const V* find(const K& key)
+	{
+		auto it = this->entries.find(key);
+		if (it == this->entries.end())
+		{
+			this->misses++;
+			return nullptr;
+		}
+
+		this->hits++;
+		this->uses.splice(this->uses.begin(), this->uses, it->second.use);
+		return &it->second.value;
+	}
+
+	/// <summary>
+	/// Finds a value without counting or reordering anything
+	/// </summary>
+	/// <param name="key">the key of the value</param>
+	/// <returns>the value, nullptr if it is not cached</returns>
+	const V* peek(const K& key) const
+	{
+		auto it = this->entries.find(key);
+		return it == this->entries.end() ? nullptr : &it->second.value;
+	}
+
+	/// <summary>
+	/// Caches a value, replacing the previous one of the key
+	/// </summary>
+	/// <param name="key">the key of the value</param>
+	/// <param name="value">the value</param>
+	void insert(const K& key, V value)
+	{
+		this->erase(key);
+
+		size_t bytes = this->sizeOf(value);
+		this->uses.push_front(key);
+		this->entries.emplace(key, Entry{ std::move(value), bytes, this->uses.begin() });
+		this->used += bytes;
+
+		this->trim();
+	}
+
+	/// <summary>
+	/// Removes the value of a key
+	/// </summary>
+	/// <param name="key">the key of the value</param>
+	void erase(const K& key)
+	{
+		auto it = this->entries.find(key);
+		if (it == this->entries.end())
+			return;
+
+		this->used -= it->second.bytes;
+		this->uses.erase(it->second.use);
+		this->entries.erase(it);
+	}
+
+	void clear()
+	{
+		this->entries.clear();
+		this->uses.clear();
+		this->used = 0;
+	}
+
+	void setBudget(const size_t& budget)
+	{
+		this->budget = budget;
+		this->trim();
+	}
+
+	size_t getBudget() const { return this->budget; }
+	size_t size() const { return this->used; }
+	int count() const { return static_cast<int>(this->entries.size()); }
+
+	uint64_t getHits() const { return this->hits; }
+	uint64_t getMisses() const { return this->misses; }
+	uint64_t getEvictions() const { return this->evictions; }
+};
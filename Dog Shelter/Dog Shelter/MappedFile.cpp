@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// <summary>
+/// Maps a file into memory as read only,
+/// an empty file is open but has no mapping
+/// </summary>
+/// <param name="fileName">the file to map</param>
+MappedFile::MappedFile(const std::string& fileName)
+{
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+
+	this->file = handle;
+	this->opened = true;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+		return;
+
+	this->mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (this->mapping == nullptr)
+	{
+		this->opened = false;
+		return;
+	}
+
+	this->data = static_cast<const char*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+	if (this->data == nullptr)
+	{
+		this->opened = false;
+		return;
+	}
+
+	this->length = static_cast<size_t>(size.QuadPart);
+#else
+	this->descriptor = open(fileName.c_str(), O_RDONLY);
+	if (this->descriptor == -1)
+		return;
+
+	this->opened = true;
+
+	struct stat info {};
+	if (fstat(this->descriptor, &info) != 0 || info.st_size == 0)
+		return;
+
+	void* address = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, this->descriptor, 0);
+	if (address == MAP_FAILED)
+	{
+		this->opened = false;
+		return;
+	}
+
+	// the file is parsed front to back exactly once
+	madvise(address, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+	this->data = static_cast<const char*>(address);
+	this->length = static_cast<size_t>(info.st_size);
+#endif
+}
+
+/// <summary>
+/// Unmaps and closes the file
+/// </summary>
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (this->data != nullptr)
+		UnmapViewOfFile(this->data);
+	if (this->mapping != nullptr)
+		CloseHandle(this->mapping);
+	if (this->file != nullptr)
+		CloseHandle(this->file);
+#else
+	if (this->data != nullptr)
+		munmap(const_cast<char*>(this->data), this->length);
+	if (this->descriptor != -1)
+		close(this->descriptor);
+#endif
+}
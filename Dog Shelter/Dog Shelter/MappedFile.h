@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+class MappedFile
+{
+private:
+	const char* data = nullptr;
+	size_t length = 0;
+	bool opened = false;
+
+#ifdef _WIN32
+	void* file = nullptr;
+	void* mapping = nullptr;
+#else
+	int descriptor = -1;
+#endif
+
+public:
+	MappedFile(const std::string& fileName);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool isOpen() const { return this->opened; }
+	std::string_view view() const { return std::string_view{ this->data, this->length }; }
+};
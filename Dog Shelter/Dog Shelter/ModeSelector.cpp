@@ -5,9 +5,12 @@
 #include "ModeSelector.h"
 #include "AdminGUI.h"
 #include "UserGUI.h"
+#include "Config.h"
 
 ModeSelector::ModeSelector(const int& repoType, QWidget* parent) : QWidget{ parent }
 {
+	this->persistenceWorker = std::make_unique<PersistenceWorker>();
+
 	switch (repoType)
 	{
 	case 0:
@@ -20,7 +23,11 @@ ModeSelector::ModeSelector(const int& repoType, QWidget* parent) : QWidget{ pare
 		throw RepositoryException("Unable to create Adoption List!");
 	}
 
-	this->repo = std::make_unique<Repository>(true, "Dogs.txt");
+	this->adoptionList->setPersistenceWorker(this->persistenceWorker.get());
+
+	this->repo = std::make_unique<Repository>(true, "Dogs.txt", true);
+	this->repo->setPersistenceWorker(this->persistenceWorker.get());
+	this->repo->setBackups(Config::getBackupGenerations());
 	this->validator = std::make_unique<DogValidator>();
 	this->serv = std::make_unique<Service>(*repo.get(), adoptionList.get(), *validator.get(), repo.get()->size() == 0);
 	
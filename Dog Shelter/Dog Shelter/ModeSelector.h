@@ -7,6 +7,7 @@
 #include "Repository.h"
 #include "Validator.h"
 #include "Service.h"
+#include "PersistenceWorker.h"
 
 class ModeSelector : public QWidget
 {
@@ -17,6 +18,8 @@ public:
 	~ModeSelector() = default;
 
 private:
+	// destroyed last, so the lists and the repository can hand it their last writes
+	std::unique_ptr<PersistenceWorker> persistenceWorker;
 	std::unique_ptr<AdoptionList> adoptionList;
 	std::unique_ptr<Repository> repo;
 	std::unique_ptr<DogValidator> validator;
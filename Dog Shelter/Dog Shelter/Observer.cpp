@@ -0,0 +1,62 @@
+#include <algorithm>
+#include "Observer.h"
+
+/// <summary>
+/// Starts sending the changes to an observer
+/// </summary>
+/// <param name="observer">the observer</param>
+void Observable::addObserver(Observer* observer)
+{
+	this->observers.push_back(observer);
+}
+
+/// <summary>
+/// Stops sending the changes to an observer
+/// </summary>
+/// <param name="observer">the observer</param>
+void Observable::removeObserver(Observer* observer)
+{
+	this->observers.erase(std::remove(this->observers.begin(), this->observers.end(), observer), this->observers.end());
+}
+
+void Observable::notifyBeforeInsert(const int& index) const
+{
+	for (Observer* observer : this->observers)
+		observer->beforeInsert(index);
+}
+
+void Observable::notifyAfterInsert(const int& index) const
+{
+	for (Observer* observer : this->observers)
+		observer->afterInsert(index);
+}
+
+void Observable::notifyBeforeRemove(const int& index) const
+{
+	for (Observer* observer : this->observers)
+		observer->beforeRemove(index);
+}
+
+void Observable::notifyAfterRemove(const int& index) const
+{
+	for (Observer* observer : this->observers)
+		observer->afterRemove(index);
+}
+
+void Observable::notifyAfterUpdate(const int& index) const
+{
+	for (Observer* observer : this->observers)
+		observer->afterUpdate(index);
+}
+
+void Observable::notifyBeforeReset() const
+{
+	for (Observer* observer : this->observers)
+		observer->beforeReset();
+}
+
+void Observable::notifyAfterReset() const
+{
+	for (Observer* observer : this->observers)
+		observer->afterReset();
+}
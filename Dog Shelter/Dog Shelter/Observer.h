@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+
+// Receives the changes of a list of dogs, positions are the ones
+// of the list at the time of the call. The before calls are made
+// while the list is unchanged, the after calls once it changed.
+class Observer
+{
+public:
+	virtual ~Observer() = default;
+
+	virtual void beforeInsert(const int&) {}
+	virtual void afterInsert(const int&) {}
+	virtual void beforeRemove(const int&) {}
+	virtual void afterRemove(const int&) {}
+	virtual void afterUpdate(const int&) {}
+
+	// every position may have changed
+	virtual void beforeReset() {}
+	virtual void afterReset() {}
+};
+
+class Observable
+{
+private:
+	std::vector<Observer*> observers;
+
+protected:
+	void notifyBeforeInsert(const int& index) const;
+	void notifyAfterInsert(const int& index) const;
+	void notifyBeforeRemove(const int& index) const;
+	void notifyAfterRemove(const int& index) const;
+	void notifyAfterUpdate(const int& index) const;
+	void notifyBeforeReset() const;
+	void notifyAfterReset() const;
+
+public:
+	Observable() = default;
+	virtual ~Observable() = default;
+
+	// the observers watch a single list, copies start without any
+	Observable(const Observable&) {}
+	Observable& operator=(const Observable&) { return *this; }
+
+	void addObserver(Observer* observer);
+	void removeObserver(Observer* observer);
+};
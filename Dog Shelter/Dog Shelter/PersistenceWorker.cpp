@@ -0,0 +1,203 @@
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include "PersistenceWorker.h"
+#include "FileUtils.h"
+#include "Validator.h"
+
+/// <summary>
+/// Starts the thread of the worker
+/// </summary>
+PersistenceWorker::PersistenceWorker()
+{
+	this->thread = std::thread{ &PersistenceWorker::run, this };
+}
+
+/// <summary>
+/// Writes every pending job and stops the thread
+/// </summary>
+PersistenceWorker::~PersistenceWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock{ this->mutex };
+		this->stopping = true;
+	}
+
+	this->wake.notify_one();
+	this->thread.join();
+}
+
+PersistenceWorker::Job& PersistenceWorker::pending(const std::string& path)
+{
+	auto it = this->jobs.find(path);
+	if (it != this->jobs.end())
+	{
+		this->coalesced++;
+		return it->second;
+	}
+
+	this->order.push_back(path);
+	return this->jobs[path];
+}
+
+/// <summary>
+/// Replaces the content of a file, the content is
+/// produced on the thread of the worker
+/// </summary>
+/// <param name="path">the file to write</param>
+/// <param name="render">produces the new content, it must not
+///						 refer to anything the caller changes later</param>
+/// <param name="backups">the number of older generations to keep</param>
+void PersistenceWorker::replace(const std::string& path, std::function<std::string()> render, const int& backups)
+{
+	{
+		std::lock_guard<std::mutex> lock{ this->mutex };
+		Job& job = this->pending(path);
+		job.render = std::move(render);
+		job.tail.clear();
+		job.backups = backups;
+		job.remove = false;
+	}
+
+	this->wake.notify_one();
+}
+
+/// <summary>
+/// Appends data to a file, after any content still pending for it
+/// </summary>
+/// <param name="path">the file to append to</param>
+/// <param name="data">the data to append</param>
+void PersistenceWorker::append(const std::string& path, const std::string& data)
+{
+	{
+		std::lock_guard<std::mutex> lock{ this->mutex };
+		Job& job = this->pending(path);
+
+		// the file goes away first, then it grows again from nothing
+		if (job.remove)
+		{
+			job.remove = false;
+			job.render = []() { return std::string{}; };
+		}
+		job.tail.append(data);
+	}
+
+	this->wake.notify_one();
+}
+
+/// <summary>
+/// Deletes a file, dropping the jobs still pending for it
+/// </summary>
+/// <param name="path">the file to delete</param>
+void PersistenceWorker::remove(const std::string& path)
+{
+	{
+		std::lock_guard<std::mutex> lock{ this->mutex };
+		Job& job = this->pending(path);
+		job.render = nullptr;
+		job.tail.clear();
+		job.remove = true;
+	}
+
+	this->wake.notify_one();
+}
+
+/// <summary>
+/// Blocks until every job submitted so far is on the disk
+/// </summary>
+void PersistenceWorker::flush()
+{
+	std::string error;
+
+	{
+		std::unique_lock<std::mutex> lock{ this->mutex };
+		this->idle.wait(lock, [this]() { return this->jobs.empty() && !this->busy; });
+		error.swap(this->error);
+	}
+
+	if (!error.empty())
+		throw FileException(error);
+}
+
+uint64_t PersistenceWorker::getWrites()
+{
+	std::lock_guard<std::mutex> lock{ this->mutex };
+	return this->writes;
+}
+
+uint64_t PersistenceWorker::getCoalesced()
+{
+	std::lock_guard<std::mutex> lock{ this->mutex };
+	return this->coalesced;
+}
+
+void PersistenceWorker::run()
+{
+	std::unique_lock<std::mutex> lock{ this->mutex };
+
+	while (true)
+	{
+		this->wake.wait(lock, [this]() { return this->stopping || !this->order.empty(); });
+		if (this->order.empty())
+			return;
+
+		std::string path = std::move(this->order.front());
+		this->order.pop_front();
+		Job job = std::move(this->jobs[path]);
+		this->jobs.erase(path);
+		this->busy = true;
+
+		lock.unlock();
+
+		std::string error;
+		try
+		{
+			this->perform(path, job);
+		}
+		catch (FileException& e)
+		{
+			error = e.what();
+		}
+		catch (std::exception&)
+		{
+			error = "The file could not be written!";
+		}
+
+		lock.lock();
+
+		this->busy = false;
+		this->writes++;
+		// the first failure is reported by the next flush
+		if (!error.empty() && this->error.empty())
+			this->error = error;
+
+		if (this->order.empty())
+			this->idle.notify_all();
+	}
+}
+
+// runs on the worker thread, without the lock
+void PersistenceWorker::perform(const std::string& path, Job& job)
+{
+	if (job.remove)
+	{
+		std::error_code error;
+		std::filesystem::remove(path, error);
+		return;
+	}
+
+	if (!job.render)
+	{
+		std::ofstream f(path, std::ios::binary | std::ios::app);
+		if (!f.is_open())
+			throw FileException("The file could not be opened!");
+
+		f.write(job.tail.data(), static_cast<std::streamsize>(job.tail.size()));
+		return;
+	}
+
+	std::string data = job.render();
+	data.append(job.tail);
+
+	FileUtils::writeDurably(path, data, job.backups);
+}
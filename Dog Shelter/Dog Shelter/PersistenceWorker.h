@@ -0,0 +1,64 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Writes files on a background thread so the GUI never waits for the disk.
+// The jobs for one path are coalesced while they wait: a new file content
+// replaces the one still pending and the appends made before it, later
+// appends are added after it. A new content replaces the file durably, see
+// FileUtils::writeDurably, so a file is either the old or the new one.
+class PersistenceWorker
+{
+private:
+	struct Job
+	{
+		// produces the new content of the file, empty for append only jobs
+		std::function<std::string()> render;
+		// written after the content, or appended to the file
+		std::string tail;
+		int backups = 0;
+		bool remove = false;
+	};
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+
+	// the paths in the order of their first pending job
+	std::list<std::string> order;
+	std::unordered_map<std::string, Job> jobs;
+	bool busy = false;
+	bool stopping = false;
+	std::string error;
+
+	uint64_t writes = 0;
+	uint64_t coalesced = 0;
+
+	std::thread thread;
+
+	void run();
+	void perform(const std::string& path, Job& job);
+	Job& pending(const std::string& path);
+
+public:
+	PersistenceWorker();
+	~PersistenceWorker();
+
+	PersistenceWorker(const PersistenceWorker&) = delete;
+	PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+	void replace(const std::string& path, std::function<std::string()> render, const int& backups = 0);
+	void append(const std::string& path, const std::string& data);
+	void remove(const std::string& path);
+	void flush();
+
+	uint64_t getWrites();
+	uint64_t getCoalesced();
+};
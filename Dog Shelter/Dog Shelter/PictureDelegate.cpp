@@ -1,14 +1,13 @@
 #include <QPainter>
-#include <QtNetwork/QNetworkReply>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "PictureDelegate.h"
 #include "Dog.h"
 
-PictureDelegate::PictureDelegate(AdoptionTableModel* model, std::unordered_map<QString, QPixmap>* images, QWidget* parent) : QStyledItemDelegate{ parent }, model{ model }
+PictureDelegate::PictureDelegate(AdoptionTableModel* model, ImageLoader* imageLoader, QWidget* parent) : QStyledItemDelegate{ parent }, model{ model }, imageLoader{ imageLoader }
 {
-	this->images = images;
-	this->networkManager = new QNetworkAccessManager{ this };
-	
-	QObject::connect(this->networkManager, &QNetworkAccessManager::finished, this, &PictureDelegate::receivedReply);
+	// repaint the cells of a photograph once it is loaded
+	QObject::connect(this->imageLoader, &ImageLoader::imageLoaded, this, [this](const QString& url) { this->model->photographChanged(url); });
 }
 
 void PictureDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const
@@ -23,55 +22,67 @@ void PictureDelegate::paint(QPainter* painter, const QStyleOptionViewItem& optio
 		return;
 	}
 	
+	QElapsedTimer timer;
+	timer.start();
+
 	QString photograph = index.model()->data(index, Qt::EditRole).toString();
+	qreal devicePixelRatio = painter->device()->devicePixelRatio();
 
-	if (this->images->find(photograph) != this->images->end())
+	// thumbnails are made off the GUI thread in device pixels at the size
+	// of the cell, so painting one is a plain copy
+	const QPixmap* cached = this->imageLoader->find(photograph, option.rect.size(), ImageFit::Stretch, devicePixelRatio);
+	if (cached != nullptr)
 	{
-		QPixmap pixmap = this->images->at(photograph);
-		painter->drawPixmap(option.rect, pixmap);
+		painter->drawPixmap(option.rect.topLeft(), *cached);
 	}
 	else
 	{
-		QUrl url{ photograph };
-		this->networkManager->get(QNetworkRequest(url));
-
-		QPixmap pixmap{};
-		pixmap.fill(Qt::white);
-
-		painter->drawPixmap(option.rect, pixmap);
+		this->imageLoader->request(photograph, option.rect.size(), ImageFit::Stretch, FetchPriority::Visible, devicePixelRatio);
+		painter->fillRect(option.rect, Qt::white);
 	}
 
+	this->frameStats.add(static_cast<uint64_t>(timer.nsecsElapsed()));
+
 	//QStyledItemDelegate::paint(painter, option, index);
 }
 
-QSize PictureDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+/// <summary>
+/// Measures the time spent painting the photographs in each frame of a view
+/// </summary>
+/// <param name="viewport">the viewport of the view using the delegate</param>
+void PictureDelegate::measure(QWidget* viewport)
 {
-	// show a picture only in the fourth column; the other columns remain unchanged
-	if (index.column() == 3)
-		return QSize(TABLE_IMAGE_WIDTH, TABLE_IMAGE_HEIGHT);
-
-	return QStyledItemDelegate::sizeHint(option, index);
+	this->viewport = viewport;
+	this->viewport->installEventFilter(this);
 }
 
-void PictureDelegate::receivedReply(QNetworkReply* reply)
+bool PictureDelegate::eventFilter(QObject* object, QEvent* event)
 {
-	QPixmap pixmap{};
-	pixmap.fill(Qt::black);
+	// the base class filters the editors; the viewport is only watched
+	if (object != this->viewport)
+		return QStyledItemDelegate::eventFilter(object, event);
 
-	if (reply->error() == QNetworkReply::NoError)
+	// the paint event is handled right after the filter,
+	// the frame ends once the event loop picks up again
+	if (event->type() == QEvent::Paint && !this->frameStats.isInFrame())
 	{
-		QByteArray replyData = reply->readAll();
-		pixmap.loadFromData(replyData);
-
-		if (pixmap.isNull())
-		{
-			pixmap = QPixmap{};
-			pixmap.fill(Qt::black);
-		}
+		this->frameStats.beginFrame();
+		QTimer::singleShot(0, this, [this]() { this->endFrame(); });
 	}
 
-	this->images->operator[](reply->url().toString()) = pixmap;
-	emit this->model->layoutChanged();
+	return false;
+}
+
+void PictureDelegate::endFrame()
+{
+	this->frameStats.endFrame();
+}
 
-	reply->deleteLater();
+QSize PictureDelegate::sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const
+{
+	// show a picture only in the fourth column; the other columns remain unchanged
+	if (index.column() == 3)
+		return QSize(TABLE_IMAGE_WIDTH, TABLE_IMAGE_HEIGHT);
+
+	return QStyledItemDelegate::sizeHint(option, index);
 }
@@ -1,10 +1,9 @@
 #pragma once
 
-#include <unordered_map>
 #include <QStyledItemDelegate>
-#include <QPixmap>
-#include <QtNetwork/QNetworkAccessManager>
 #include "AdoptionTableModel.h"
+#include "ImageLoader.h"
+#include "FrameStats.h"
 
 #define TABLE_IMAGE_WIDTH 32
 #define TABLE_IMAGE_HEIGHT 96
@@ -14,16 +13,22 @@ class PictureDelegate : public QStyledItemDelegate
 private:
 	AdoptionTableModel* model;
 
-	QNetworkAccessManager* networkManager;
-	std::unordered_map<QString, QPixmap>* images;
+	ImageLoader* imageLoader;
+
+	// the paint time of each frame of the measured viewport
+	QWidget* viewport = nullptr;
+	mutable FrameStats frameStats;
+
+	void endFrame();
 
 public:
-	PictureDelegate(AdoptionTableModel* model, std::unordered_map<QString, QPixmap>* images, QWidget* parent = Q_NULLPTR);
-	~PictureDelegate() = default;
+	PictureDelegate(AdoptionTableModel* model, ImageLoader* imageLoader, QWidget* parent = Q_NULLPTR);
+
+	void measure(QWidget* viewport);
+	const FrameStats& getFrameStats() const { return this->frameStats; }
+
+	bool eventFilter(QObject* object, QEvent* event) override;
 
 	void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
 	QSize sizeHint(const QStyleOptionViewItem& option, const QModelIndex& index) const override;
-
-public slots:
-	void receivedReply(QNetworkReply* reply);
 };
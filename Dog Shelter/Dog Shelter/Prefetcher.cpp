@@ -0,0 +1,56 @@
+#include "Prefetcher.h"
+
+/// <summary>
+/// Finds the dogs shown after the current one, wrapping
+/// around to the first dog like the browsing does
+/// </summary>
+/// <param name="current">the position of the dog on screen</param>
+/// <param name="size">the number of dogs being browsed</param>
+/// <returns>the positions of the dogs to prefetch, nearest first</returns>
+std::vector<int> Prefetcher::next(const int& current, const int& size) const
+{
+	std::vector<int> result;
+	if (size <= 1 || current < 0)
+		return result;
+
+	// a short list would otherwise come back to the current dog
+	int count = this->count < size - 1 ? this->count : size - 1;
+	for (int i = 1; i <= count; i++)
+		result.push_back((current + i) % size);
+
+	return result;
+}
+
+/// <summary>
+/// Records whether the photograph of a shown dog was ready
+/// </summary>
+/// <param name="url">the photograph of the dog</param>
+/// <param name="ready">true if the photograph could be shown right away</param>
+void Prefetcher::shown(const std::string& url, const bool& ready)
+{
+	auto it = this->prefetched.find(url);
+	if (it == this->prefetched.end())
+	{
+		// already cached before any prefetch, says nothing about the look-ahead
+		if (!ready)
+			this->misses++;
+		return;
+	}
+
+	if (ready)
+		this->hits++;
+	else
+		this->late++;
+
+	this->prefetched.erase(it);
+}
+
+/// <summary>
+/// The share of the shown photographs the look-ahead had ready
+/// </summary>
+/// <returns>the hit rate between 0 and 1, 0 if nothing was shown</returns>
+double Prefetcher::hitRate() const
+{
+	uint64_t total = this->hits + this->late + this->misses;
+	return total == 0 ? 0.0 : static_cast<double>(this->hits) / static_cast<double>(total);
+}
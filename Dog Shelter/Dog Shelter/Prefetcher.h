@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Picks the dogs whose photographs are fetched ahead while browsing one
+// by one, and measures how often the photograph was ready when shown
+class Prefetcher
+{
+private:
+	int count;
+	std::unordered_set<std::string> prefetched;
+
+	uint64_t hits = 0;
+	uint64_t late = 0;
+	uint64_t misses = 0;
+
+public:
+	Prefetcher(const int& count) : count{ count } {}
+
+	std::vector<int> next(const int& current, const int& size) const;
+	void prefetch(const std::string& url) { this->prefetched.insert(url); }
+	void shown(const std::string& url, const bool& ready);
+	void reset() { this->prefetched.clear(); }
+
+	// hits were prefetched and ready, late ones were prefetched but still
+	// on their way, misses were never prefetched and not cached either
+	uint64_t getHits() const { return this->hits; }
+	uint64_t getLate() const { return this->late; }
+	uint64_t getMisses() const { return this->misses; }
+	double hitRate() const;
+
+	int getCount() const { return this->count; }
+};
@@ -1,73 +1,698 @@
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
-#include <sstream>
 #include "Repository.h"
 #include "Validator.h"
+#include "Utils.h"
+#include "MappedFile.h"
+#include "Snapshot.h"
+#include "FileUtils.h"
+
+/// <summary>
+/// Serializes the fields of a dog for a journal record
+/// </summary>
+/// <param name="dog">the dog to serialize</param>
+/// <returns>the comma separated fields of the dog</returns>
+static std::string journalFields(const Dog& dog)
+{
+	return dog.getName() + "," + dog.getBreed() + "," + std::to_string(dog.getAge()) + "," + dog.getPhotohraph();
+}
+
+/// <summary>
+/// Hashes the (name, breed) pair of a dog
+/// </summary>
+/// <param name="key">the key to hash</param>
+/// <returns>the combined hash of the name and the breed</returns>
+size_t DogKeyHash::operator()(const DogKey& key) const
+{
+	size_t seed = std::hash<std::string>{}(key.first);
+	return seed ^ (std::hash<std::string>{}(key.second) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
 
 /// <summary>
 /// Constructor for the class, automatically reads
 /// from the .txt file when created if init is true
 /// </summary>
-Repository::Repository(const bool& init, const std::string& fileName) : fileName{ fileName }
+/// <param name="init">whether or not to read the file</param>
+/// <param name="fileName">the file backing the repository</param>
+/// <param name="journaled">whether or not mutations are appended
+///							to a journal instead of rewriting the file</param>
+Repository::Repository(const bool& init, const std::string& fileName, const bool& journaled) : fileName{ fileName }, journaled{ journaled }
 {
 	if (init)
 		this->read();
 }
 
 /// <summary>
-/// Reads all the dogs from the TXT file into the repository
+/// Reads all the dogs from the file into the repository,
+/// the repository keeps writing in the format it found
 /// </summary>
 void Repository::read()
 {
 	if (this->fileName.empty()) return;
 
-	std::ifstream f(this->fileName);
-	if (!f.is_open())
+	// a file torn by a crash is replaced by its newest valid backup
+	FileUtils::recover(this->fileName);
+	this->format = this->load(this->fileName);
+
+	// replay the mutations that were not yet folded into the file,
+	// a leftover .old journal means a compaction was interrupted
+	if (this->journaled)
+	{
+		this->replayJournal(this->journalName() + ".old");
+		this->replayJournal(this->journalName());
+	}
+}
+
+/// <summary>
+/// Loads the dogs of a text or binary file, the file is mapped
+/// into memory and the dogs are read from it in place,
+/// dogs that are already in the repository are skipped
+/// </summary>
+/// <param name="fileName">the file to load</param>
+/// <returns>the format of the file</returns>
+StorageFormat Repository::load(const std::string& fileName)
+{
+	MappedFile file{ fileName };
+	if (!file.isOpen())
 		throw FileException("The file could not be opened!");
 
+	std::string_view data;
+	if (FileUtils::verifyChecksum(file.view(), data) == ChecksumStatus::Invalid)
+		throw FileException("The file is corrupted!");
+
 	Dog dog{};
-	while (f >> dog)
-		this->add(dog);
 
-	f.close();
+	if (Snapshot::isSnapshot(data))
+	{
+		SnapshotReader reader{ data };
+		if (!reader.isValid())
+			throw FileException("The file is corrupted!");
+
+		{
+			std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+			this->dogs.reserve(this->dogs.size() + reader.size());
+		}
+		this->columns.reserve(this->dogs.size() + reader.size());
+		this->keys.reserve(this->keys.size() + reader.size());
+		this->ids.reserve(this->ids.size() + reader.size());
+
+		for (size_t i = 0; i < reader.size(); i++)
+		{
+			if (!reader.read(i, dog))
+				throw FileException("The file is corrupted!");
+
+			this->tryInsert(dog);
+		}
+
+		return StorageFormat::Binary;
+	}
+
+	// size the vector and the index once instead of growing them per dog
+	size_t lines = static_cast<size_t>(std::count(data.begin(), data.end(), '\n'));
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.reserve(this->dogs.size() + lines + 1);
+	}
+	this->columns.reserve(this->dogs.size() + lines + 1);
+	this->keys.reserve(this->keys.size() + lines + 1);
+	this->ids.reserve(this->ids.size() + lines + 1);
+
+	forEachLine(data, [this, &dog](std::string_view line)
+		{
+			if (dog.parse(line))
+				this->tryInsert(dog);
+		});
+
+	return StorageFormat::Text;
+}
+
+/// <summary>
+/// Waits for the writes that still read the dogs of the repository
+/// </summary>
+Repository::~Repository()
+{
+	try
+	{
+		this->flush();
+	}
+	catch (FileException&)
+	{
+	}
+
+	this->waitForCompaction();
 }
 
 /// <summary>
-/// Writes a TXT file of the adoption list
+/// Writes the file of the repository, by the persistence worker if one
+/// is set, which copies the dogs only once it gets to the file, so the
+/// writes requested meanwhile coalesce into that single copy
 /// </summary>
 void Repository::write()
 {
 	if (this->fileName.empty()) return;
 
-	std::ofstream f(this->fileName);
-	if (!f.is_open())
-		throw FileException("The file could not be opened!");
+	if (this->worker != nullptr)
+	{
+		this->worker->replace(this->fileName, [this, format = this->format]() { return encodeFile(this->snapshot(), format); }, this->backups);
+		return;
+	}
+
+	writeFile(this->fileName, this->dogs, this->format, this->backups);
+}
+
+/// <summary>
+/// Copies the dogs, called by the persistence worker
+/// while the repository may be changing them
+/// </summary>
+/// <returns>the dogs as they are now</returns>
+std::vector<Dog> Repository::snapshot()
+{
+	std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+	return this->dogs;
+}
+
+/// <summary>
+/// Encodes dogs in the given format, followed by a checksum line,
+/// the text lines hold the fields of the dog and its id
+/// </summary>
+/// <param name="dogs">the dogs to encode</param>
+/// <param name="format">the format of the file</param>
+/// <returns>the contents of the file</returns>
+std::string Repository::encodeFile(const std::vector<Dog>& dogs, const StorageFormat& format)
+{
+	std::string data;
+	if (format == StorageFormat::Binary)
+	{
+		data = Snapshot::encode(dogs);
+	}
+	else
+	{
+		for (const Dog& dog : dogs)
+		{
+			data.append(journalFields(dog)).push_back(',');
+			data.append(std::to_string(dog.getId())).push_back('\n');
+		}
+	}
+
+	FileUtils::appendChecksum(data);
+	return data;
+}
+
+/// <summary>
+/// Writes dogs to a file in the given format
+/// </summary>
+/// <param name="fileName">the file to write</param>
+/// <param name="dogs">the dogs to write</param>
+/// <param name="format">the format of the file</param>
+/// <param name="backups">the number of older generations to keep</param>
+void Repository::writeFile(const std::string& fileName, const std::vector<Dog>& dogs, const StorageFormat& format, const int& backups)
+{
+	FileUtils::writeDurably(fileName, encodeFile(dogs, format), backups);
+}
+
+/// <summary>
+/// Blocks until the writes handed to the persistence worker are on the disk
+/// </summary>
+void Repository::flush()
+{
+	if (this->worker != nullptr)
+		this->worker->flush();
+}
+
+/// <summary>
+/// Writes every dog to the file, folding the journal into it
+/// </summary>
+void Repository::save()
+{
+	if (this->fileName.empty()) return;
+	this->waitForCompaction();
+
+	this->write();
+	// the journal may only go once the file holds its records
+	this->flush();
+
+	// the mutations of a running batch are in the file now
+	this->pendingWrite = false;
+	this->pendingJournal.clear();
+	this->pendingRecords = 0;
+
+	if (this->journaled)
+	{
+		std::filesystem::remove(this->journalName());
+		std::filesystem::remove(this->journalName() + ".old");
+		this->journalRecords = 0;
+	}
+}
+
+/// <summary>
+/// Adds the dogs of a text or binary file to the repository,
+/// the dogs that are already in the shelter are kept as they are
+/// </summary>
+/// <param name="fileName">the file to import</param>
+void Repository::importFrom(const std::string& fileName)
+{
+	this->load(fileName);
+	this->save();
+}
+
+/// <summary>
+/// Writes the dogs to a file other than the one of the repository
+/// </summary>
+/// <param name="fileName">the file to write</param>
+/// <param name="format">the format of the file</param>
+void Repository::exportTo(const std::string& fileName, const StorageFormat& format) const
+{
+	writeFile(fileName, this->dogs, format);
+}
+
+/// <summary>
+/// Persists a mutation: the record goes to the journal, or the
+/// whole file is rewritten; inside a batch both are deferred
+/// </summary>
+/// <param name="record">the journal record of the mutation</param>
+void Repository::persist(const std::string& record)
+{
+	if (this->fileName.empty()) return;
+
+	if (this->batchDepth > 0)
+	{
+		if (this->journaled)
+		{
+			this->pendingJournal.append(record).push_back('\n');
+			this->pendingRecords++;
+		}
+
+		this->pendingWrite = true;
+		return;
+	}
+
+	if (this->journaled)
+		this->appendJournal(record + '\n', 1);
+	else
+		this->write();
+}
+
+/// <summary>
+/// Appends mutation records to the journal and folds
+/// the journal into the file once it grows too large
+/// </summary>
+/// <param name="records">the records to append, one per line</param>
+/// <param name="count">the number of records</param>
+void Repository::appendJournal(const std::string& records, const int& count)
+{
+	if (this->fileName.empty()) return;
+
+	if (this->worker != nullptr)
+	{
+		this->worker->append(this->journalName(), records);
+	}
+	else
+	{
+		std::ofstream f(this->journalName(), std::ios::app);
+		if (!f.is_open())
+			throw FileException("The journal could not be opened!");
+
+		f << records;
+		f.close();
+	}
+
+	this->journalRecords += count;
+	if (this->journalRecords >= JOURNAL_COMPACT_THRESHOLD)
+		this->compact();
+}
+
+/// <summary>
+/// Starts a batch, the mutations made until the matching
+/// endBatch are persisted together with a single write
+/// </summary>
+void Repository::beginBatch()
+{
+	this->batchDepth++;
+}
+
+/// <summary>
+/// Ends a batch and persists its mutations once
+/// </summary>
+void Repository::endBatch()
+{
+	if (this->batchDepth == 0 || --this->batchDepth > 0 || !this->pendingWrite)
+		return;
+
+	this->pendingWrite = false;
+
+	if (this->journaled)
+	{
+		std::string records;
+		records.swap(this->pendingJournal);
+
+		int count = this->pendingRecords;
+		this->pendingRecords = 0;
+
+		this->appendJournal(records, count);
+	}
+	else
+	{
+		this->write();
+	}
+}
+
+/// <summary>
+/// Starts a batch of the repository
+/// </summary>
+/// <param name="repo">the repository</param>
+RepositoryBatch::RepositoryBatch(Repository& repo) : repo{ repo }
+{
+	this->repo.beginBatch();
+}
+
+/// <summary>
+/// Ends the batch unless end did, a failed write is dropped
+/// as the scope is left by an exception already
+/// </summary>
+RepositoryBatch::~RepositoryBatch()
+{
+	if (!this->open) return;
 
-	for (const Dog& dog : this->dogs)
+	try
+	{
+		this->repo.endBatch();
+	}
+	catch (std::exception&)
 	{
-		f << dog;
+	}
+}
+
+/// <summary>
+/// Ends the batch and persists its mutations once
+/// </summary>
+void RepositoryBatch::end()
+{
+	if (!this->open) return;
+
+	this->open = false;
+	this->repo.endBatch();
+}
+
+/// <summary>
+/// Applies every record of a journal file to the vector of dogs
+/// </summary>
+/// <param name="journalFile">the journal to replay</param>
+void Repository::replayJournal(const std::string& journalFile)
+{
+	std::ifstream f(journalFile);
+	if (!f.is_open()) return;
+
+	std::string record;
+	while (std::getline(f, record))
+	{
+		this->applyJournalRecord(record);
+		this->journalRecords++;
 	}
 
 	f.close();
 }
 
 /// <summary>
-/// Adds a dog to the vector of dogs
+/// Applies a single journal record, records are applied as upserts
+/// so replaying a journal that was already folded is harmless
 /// </summary>
-/// <param name="dog">the dog to add</param>
-void Repository::add(const Dog& dog, int index)
+/// <param name="record">the record to apply</param>
+void Repository::applyJournalRecord(const std::string& record)
 {
-	Dog d{};
+	std::vector<std::string> tokens = tokenize(record, ',');
+	if (tokens.empty()) return;
+
 	try
 	{
-		d = this->findByNameAndBreed(dog.getName(), dog.getBreed());
-		throw DuplicateDogException();
+		if (tokens[0] == "+" && (tokens.size() == 6 || tokens.size() == 7))
+		{
+			// journals written before the ids lack the last field
+			Dog dog{ tokens[2], tokens[3], std::stoi(tokens[4]), tokens[5] };
+			if (tokens.size() == 7)
+				dog.setId(std::stoull(tokens[6]));
+			int existing = this->indexOfKey(dog.getName(), dog.getBreed());
+
+			if (existing != -1)
+				this->assign(existing, dog);
+			else
+				this->insert(dog, std::stoi(tokens[1]));
+		}
+		else if (tokens[0] == "-" && tokens.size() == 3)
+		{
+			int existing = this->indexOfKey(tokens[1], tokens[2]);
+			if (existing != -1)
+				this->erase(existing);
+		}
+		else if (tokens[0] == "~" && tokens.size() == 7)
+		{
+			Dog dog{ tokens[3], tokens[4], std::stoi(tokens[5]), tokens[6] };
+			int position = this->indexOfKey(tokens[1], tokens[2]);
+			int existing = this->indexOfKey(dog.getName(), dog.getBreed());
+
+			// the dog keeps its id unless the record collides with another dog
+			if (position != -1 && (existing == -1 || existing == position))
+			{
+				this->assign(position, dog);
+				return;
+			}
+
+			if (position != -1)
+			{
+				this->erase(position);
+				existing = this->indexOfKey(dog.getName(), dog.getBreed());
+			}
+
+			if (existing != -1)
+				this->assign(existing, dog);
+			else
+				this->insert(dog, position);
+		}
+	}
+	catch (std::exception&)
+	{
+		// a torn record left behind by a crash, skip it
 	}
-	catch (InexistenDogException&) {}
+}
+
+/// <summary>
+/// Folds the journal into the file on a background thread,
+/// new mutations keep going to a fresh journal meanwhile
+/// </summary>
+void Repository::compact()
+{
+	if (this->fileName.empty() || !this->journaled) return;
+	this->waitForCompaction();
+	// the journal is renamed below, its pending records go in first
+	this->flush();
+
+	std::string journal = this->journalName();
+	std::string oldJournal = journal + ".old";
+	if (!std::filesystem::exists(journal)) return;
+
+	if (std::filesystem::exists(oldJournal))
+	{
+		// an interrupted compaction left records behind, keep them
+		std::ifstream in(journal);
+		std::ofstream out(oldJournal, std::ios::app);
+		out << in.rdbuf();
+		in.close();
+		out.close();
+
+		std::filesystem::remove(journal);
+	}
+	else
+	{
+		std::filesystem::rename(journal, oldJournal);
+	}
+	this->journalRecords = 0;
+
+	std::vector<Dog> snapshot = this->dogs;
+	std::string base = this->fileName;
+	StorageFormat format = this->format;
+	int backups = this->backups;
+
+	this->compaction = std::async(std::launch::async, [snapshot, base, oldJournal, format, backups]()
+		{
+			try
+			{
+				writeFile(base, snapshot, format, backups);
+			}
+			catch (FileException&)
+			{
+				return;
+			}
+
+			// the old journal is only dropped once the new file is in place
+			std::error_code error;
+			std::filesystem::remove(oldJournal, error);
+		}).share();
+}
+
+/// <summary>
+/// Blocks until the running compaction (if any) is finished
+/// </summary>
+void Repository::waitForCompaction()
+{
+	if (this->compaction.valid())
+		this->compaction.wait();
+}
+
+/// <summary>
+/// Gives a dog the next id unless it brings one the repository
+/// does not use yet, such as a dog put back by an undo
+/// </summary>
+/// <param name="dog">the dog receiving the id</param>
+void Repository::assignId(Dog& dog)
+{
+	if (dog.getId() == 0 || this->ids.find(dog.getId()) != this->ids.end())
+		dog.setId(this->nextId++);
+	else if (dog.getId() >= this->nextId)
+		this->nextId = dog.getId() + 1;
+}
+
+/// <summary>
+/// Inserts a dog into the vector of dogs without persisting it
+/// </summary>
+/// <param name="dog">the dog to insert</param>
+/// <param name="index">the position of the dog, appended if invalid</param>
+/// <returns>the position the dog was inserted at</returns>
+int Repository::insert(const Dog& dog, int index)
+{
+	DogKey key{ dog.getName(), dog.getBreed() };
+	if (this->keys.find(key) != this->keys.end())
+		throw DuplicateDogException();
 
 	if (index < 0 || index > this->size()) index = this->size();
-	this->dogs.insert(this->dogs.begin() + index, dog);
-	this->write();
+	this->notifyBeforeInsert(index);
+
+	Dog stored = dog;
+	this->assignId(stored);
+
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.insert(this->dogs.begin() + index, stored);
+	}
+	this->columns.insert(index, stored);
+	this->searchIndex.insert(index, stored);
+	this->version++;
+
+	this->keys.emplace(std::move(key), stored.getId());
+	this->ids[stored.getId()] = index;
+	this->reindex(index + 1);
+
+	this->notifyAfterInsert(index);
+	return index;
+}
+
+/// <summary>
+/// Appends a dog unless it is already in the repository
+/// </summary>
+/// <param name="dog">the dog to append</param>
+void Repository::tryInsert(const Dog& dog)
+{
+	auto result = this->keys.try_emplace(DogKey{ dog.getName(), dog.getBreed() }, 0);
+	if (!result.second)
+		return;
+
+	int index = this->size();
+	this->notifyBeforeInsert(index);
+
+	Dog stored = dog;
+	this->assignId(stored);
+	result.first->second = stored.getId();
+	this->ids[stored.getId()] = index;
+
+	this->columns.insert(index, stored);
+	this->searchIndex.insert(index, stored);
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.push_back(std::move(stored));
+	}
+	this->version++;
+
+	this->notifyAfterInsert(index);
+}
+
+/// <summary>
+/// Erases the dog at a position without persisting it
+/// </summary>
+/// <param name="index">the position of the dog</param>
+void Repository::erase(const int& index)
+{
+	this->notifyBeforeRemove(index);
+
+	const Dog& dog = this->dogs[index];
+	this->keys.erase(DogKey{ dog.getName(), dog.getBreed() });
+	this->ids.erase(dog.getId());
+	this->searchIndex.erase(index, dog);
+
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.erase(this->dogs.begin() + index);
+	}
+	this->columns.erase(index);
+	this->version++;
+	this->reindex(index);
+
+	this->notifyAfterRemove(index);
+}
+
+/// <summary>
+/// Replaces the dog at a position without persisting it,
+/// the dog keeps the id it had there
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="dog">the new dog</param>
+void Repository::assign(const int& index, const Dog& dog)
+{
+	const Dog& oldDog = this->dogs[index];
+	uint64_t id = oldDog.getId();
+	this->keys.erase(DogKey{ oldDog.getName(), oldDog.getBreed() });
+	this->searchIndex.assign(index, oldDog, dog);
+
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs[index] = dog;
+		this->dogs[index].setId(id);
+	}
+	this->columns.assign(index, dog);
+	this->version++;
+	this->keys[DogKey{ dog.getName(), dog.getBreed() }] = id;
+
+	this->notifyAfterUpdate(index);
+}
+
+/// <summary>
+/// Marks the positions of the dogs that moved as stale
+/// </summary>
+/// <param name="from">the first position that moved</param>
+void Repository::reindex(const int& from)
+{
+	this->staleFrom = std::min(this->staleFrom, from);
+}
+
+/// <summary>
+/// Refreshes the stale positions of the dogs, see reindex
+/// </summary>
+void Repository::renumber() const
+{
+	for (int i = this->staleFrom; i < this->size(); i++)
+		this->ids[this->dogs[i].getId()] = i;
+
+	this->staleFrom = std::numeric_limits<int>::max();
+}
+
+/// <summary>
+/// Adds a dog to the vector of dogs
+/// </summary>
+/// <param name="dog">the dog to add</param>
+void Repository::add(const Dog& dog, int index)
+{
+	index = this->insert(dog, index);
+
+	if (!this->fileName.empty())
+		this->persist("+," + std::to_string(index) + "," + journalFields(this->dogs[index]) + "," + std::to_string(this->dogs[index].getId()));
 }
 
 /// <summary>
@@ -76,12 +701,7 @@ void Repository::add(const Dog& dog, int index)
 /// <param name="dog">the dog to remove</param>
 void Repository::remove(const Dog& dog)
 {
-	auto it = std::find(this->dogs.begin(), this->dogs.end(), dog);
-	if (it == this->dogs.end())
-		throw InexistenDogException{};
-
-	this->dogs.erase(it);
-	this->write();
+	this->removeAt(-1, dog);
 }
 
 /// <summary>
@@ -91,30 +711,163 @@ void Repository::remove(const Dog& dog)
 /// <param name="newDog">the new dog</param>
 void Repository::update(const Dog& oldDog, const Dog& newDog)
 {
-	for (auto& dog : this->dogs)
+	this->updateAt(-1, oldDog, newDog);
+}
+
+/// <summary>
+/// Removes the dog found at a known position, the position is only a hint:
+/// if the dog is not there anymore it is looked up by its key
+/// </summary>
+/// <param name="index">where the dog is expected to be, -1 if unknown</param>
+/// <param name="dog">the dog to remove</param>
+void Repository::removeAt(const int& index, const Dog& dog)
+{
+	int position = this->locate(index, dog);
+	if (position == -1)
+		throw InexistenDogException{};
+
+	DogKey key{ this->dogs[position].getName(), this->dogs[position].getBreed() };
+	this->erase(position);
+
+	if (!this->fileName.empty())
+		this->persist("-," + key.first + "," + key.second);
+}
+
+/// <summary>
+/// Updates the dog found at a known position, the position is only a hint:
+/// if the dog is not there anymore it is looked up by its key
+/// </summary>
+/// <param name="index">where the old dog is expected to be, -1 if unknown</param>
+/// <param name="oldDog">the old dog</param>
+/// <param name="newDog">the new dog</param>
+void Repository::updateAt(const int& index, const Dog& oldDog, const Dog& newDog)
+{
+	int position = this->locate(index, oldDog);
+	if (position == -1)
+		throw InexistenDogException{};
+
+	// the dog is found by its id, its key is the one it has now
+	DogKey key{ this->dogs[position].getName(), this->dogs[position].getBreed() };
+
+	// only a changed key can collide with another dog
+	if (key.first != newDog.getName() || key.second != newDog.getBreed())
 	{
-		if (dog == oldDog)
-		{
-			dog = newDog;
-			this->write();
-			return;
-		}
+		int existing = this->indexOfKey(newDog.getName(), newDog.getBreed());
+		if (existing != -1 && existing != position)
+			throw DuplicateDogException{};
 	}
 
-	throw InexistenDogException{};
+	this->assign(position, newDog);
+
+	if (!this->fileName.empty())
+		this->persist("~," + key.first + "," + key.second + "," + journalFields(newDog));
 }
 
 /// <summary>
-/// returns the index of a dog
+/// Sorts the dogs in memory
+/// </summary>
+/// <param name="comparator">the comparator used for sorting</param>
+void Repository::sort(Comparator<Dog>* comparator)
+{
+	this->notifyBeforeReset();
+
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		genericSort<Dog>(this->dogs, comparator);
+	}
+	this->version++;
+	this->reindex(0);
+
+	this->searchIndex.reset();
+	this->columns.clear();
+	for (int i = 0; i < this->size(); i++)
+		this->columns.insert(i, this->dogs[i]);
+
+	this->notifyAfterReset();
+}
+
+/// <summary>
+/// Removes every dog from memory
+/// </summary>
+void Repository::clear()
+{
+	this->notifyBeforeReset();
+
+	{
+		std::lock_guard<std::mutex> lock{ *this->dogsMutex };
+		this->dogs.clear();
+	}
+	this->keys.clear();
+	this->ids.clear();
+	this->staleFrom = std::numeric_limits<int>::max();
+	this->columns.clear();
+	this->searchIndex.reset();
+	this->version++;
+
+	this->notifyAfterReset();
+}
+
+/// <summary>
+/// returns the index of a dog, found by its id if it has one
+/// from this repository and by its name and breed otherwise
 /// </summary>
 /// <param name="dog">the dog to look for</param>
 /// <returns>the index of the found dog,
 ///			 -1 if the dog is not found</returns>
 int Repository::indexOf(const Dog& dog) const
 {
-	auto it = std::find(this->dogs.begin(), this->dogs.end(), dog);
+	if (dog.getId() != 0)
+	{
+		int index = this->indexOfId(dog.getId());
+		if (index != -1)
+			return index;
+	}
 
-	return it == this->dogs.end() ? -1 : static_cast<int>(it - this->dogs.begin());
+	return this->indexOfKey(dog.getName(), dog.getBreed());
+}
+
+/// <summary>
+/// returns the index of the dog with an id
+/// </summary>
+/// <param name="id">the id of the dog</param>
+/// <returns>the index of the found dog,
+///			 -1 if the dog is not found</returns>
+int Repository::indexOfId(const uint64_t& id) const
+{
+	if (this->staleFrom < this->size())
+		this->renumber();
+
+	auto it = this->ids.find(id);
+
+	return it == this->ids.end() ? -1 : it->second;
+}
+
+/// <summary>
+/// returns the index of the dog with a name and a breed
+/// </summary>
+/// <param name="name">the name of the dog</param>
+/// <param name="breed">the breed of the dog</param>
+/// <returns>the index of the found dog,
+///			 -1 if the dog is not found</returns>
+int Repository::indexOfKey(const std::string& name, const std::string& breed) const
+{
+	auto it = this->keys.find(DogKey{ name, breed });
+
+	return it == this->keys.end() ? -1 : this->indexOfId(it->second);
+}
+
+/// <summary>
+/// Checks a remembered position of a dog before falling back to a lookup
+/// </summary>
+/// <param name="index">where the dog is expected to be, -1 if unknown</param>
+/// <param name="dog">the dog to look for</param>
+/// <returns>the index of the dog, -1 if the dog is not found</returns>
+int Repository::locate(const int& index, const Dog& dog) const
+{
+	if (dog.getId() != 0 && index >= 0 && index < this->size() && this->dogs[index].getId() == dog.getId())
+		return index;
+
+	return this->indexOf(dog);
 }
 
 /// <summary>
@@ -123,13 +876,74 @@ int Repository::indexOf(const Dog& dog) const
 /// <param name="name">the name of the dog</param>
 /// <param name="breed">the breed of the dog</param>
 /// <returns>the found dog</returns>
-Dog& Repository::findByNameAndBreed(const std::string& name, const std::string& breed)
+const Dog& Repository::findByNameAndBreed(const std::string& name, const std::string& breed) const
+{
+	int index = this->indexOfKey(name, breed);
+	if (index == -1)
+		throw InexistenDogException{};
+
+	return this->dogs[index];
+}
+
+/// <summary>
+/// Searches for the dog with an id, throws an error if it doesn't exist
+/// </summary>
+/// <param name="id">the id of the dog</param>
+/// <returns>the found dog</returns>
+const Dog& Repository::findById(const uint64_t& id) const
+{
+	int index = this->indexOfId(id);
+	if (index == -1)
+		throw InexistenDogException{};
+
+	return this->dogs[index];
+}
+
+/// <summary>
+/// Finds the dogs of a breed younger than an age
+/// </summary>
+/// <param name="breed">the breed to filter by, empty for any breed</param>
+/// <param name="age">the exclusive upper bound of the age</param>
+/// <returns>the positions of the matching dogs</returns>
+std::vector<int> Repository::filterByBreedAndAge(const std::string& breed, const int& age) const
 {
-	for (auto& dog : this->dogs)
+	return this->columns.filterByBreedAndAge(breed, age, this->dogs);
+}
+
+/// <summary>
+/// Finds the dogs whose name or breed contains a text, the trigram
+/// index is built on the first search and maintained afterwards
+/// </summary>
+/// <param name="text">the text to look for, empty for every dog</param>
+/// <param name="ignoreCase">true to compare ASCII letters case insensitively</param>
+/// <returns>the positions of the matching dogs</returns>
+std::vector<int> Repository::search(const std::string& text, const bool& ignoreCase) const
+{
+	if (!this->searchIndex.isBuilt())
+		this->searchIndex.build(this->dogs);
+
+	auto matches = [this, &text, &ignoreCase](const int& index)
+	{
+		const Dog& dog = this->dogs[index];
+		return contains(dog.getName(), text, ignoreCase) || contains(dog.getBreed(), text, ignoreCase);
+	};
+
+	std::vector<int> result;
+	std::vector<int> candidates;
+
+	if (this->searchIndex.candidates(text, candidates))
+	{
+		// the trigrams only narrow the search, the candidates still have to match
+		for (const int& index : candidates)
+			if (matches(index))
+				result.push_back(index);
+	}
+	else
 	{
-		if (dog.getName() == name && dog.getBreed() == breed)
-			return dog;
+		for (int i = 0; i < this->size(); i++)
+			if (matches(i))
+				result.push_back(i);
 	}
 
-	throw InexistenDogException{};
+	return result;
 }
@@ -2,30 +2,153 @@
 
 #include <vector>
 #include <string>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
 #include "Dog.h"
+#include "Comparator.h"
+#include "DogColumns.h"
+#include "TrigramIndex.h"
+#include "Observer.h"
+#include "PersistenceWorker.h"
 
-class Repository
+// number of journal records after which the journal is folded into the base file
+#define JOURNAL_COMPACT_THRESHOLD 1000
+
+// the (name, breed) pair that has to be unique, see Dog::operator==,
+// the dogs are otherwise identified by the ids the repository assigns
+typedef std::pair<std::string, std::string> DogKey;
+
+enum class StorageFormat
+{
+	Text,
+	Binary
+};
+
+struct DogKeyHash
+{
+	size_t operator()(const DogKey& key) const;
+};
+
+class Repository : public Observable
 {
 private:
 	std::vector<Dog> dogs;
+	// guards the changes to the dogs against the copy the persistence
+	// worker makes, the repository itself reads them without it,
+	// copies of the repository share it as the mutex cannot be copied
+	std::shared_ptr<std::mutex> dogsMutex = std::make_shared<std::mutex>();
+	// the id of every key, only used to keep the keys unique and to find
+	// dogs by name, the positions of the dogs are kept per id
+	std::unordered_map<DogKey, uint64_t, DogKeyHash> keys;
+	// every id is there, but the positions from staleFrom on moved since
+	// and are renumbered by the next indexOfId, once for a whole batch
+	mutable std::unordered_map<uint64_t, int> ids;
+	mutable int staleFrom = std::numeric_limits<int>::max();
+	uint64_t nextId = 1;
+	DogColumns columns;
+	mutable TrigramIndex searchIndex;
+	uint64_t version = 0;
 	std::string fileName;
+	StorageFormat format = StorageFormat::Text;
+	// writes the file and the journal in the background when set
+	PersistenceWorker* worker = nullptr;
+	// older generations of the file kept when it is replaced
+	int backups = 0;
+
+	bool journaled;
+	int journalRecords = 0;
+	std::shared_future<void> compaction;
+
+	int batchDepth = 0;
+	bool pendingWrite = false;
+	std::string pendingJournal;
+	int pendingRecords = 0;
 
 	void read();
 	void write();
+	StorageFormat load(const std::string& fileName);
+	std::vector<Dog> snapshot();
+	static std::string encodeFile(const std::vector<Dog>& dogs, const StorageFormat& format);
+	static void writeFile(const std::string& fileName, const std::vector<Dog>& dogs, const StorageFormat& format, const int& backups = 0);
+	int insert(const Dog& dog, int index = -1);
+	void tryInsert(const Dog& dog);
+	void erase(const int& index);
+	void assign(const int& index, const Dog& dog);
+	void reindex(const int& from);
+	void renumber() const;
+	int locate(const int& index, const Dog& dog) const;
+	int indexOfKey(const std::string& name, const std::string& breed) const;
+	void assignId(Dog& dog);
+
+	std::string journalName() const { return this->fileName + ".journal"; }
+	void persist(const std::string& record);
+	void appendJournal(const std::string& records, const int& count);
+	void replayJournal(const std::string& journalFile);
+	void applyJournalRecord(const std::string& record);
 
 public:
-	Repository(const bool& init = false, const std::string& fileName = "");
+	Repository(const bool& init = false, const std::string& fileName = "", const bool& journaled = false);
+	~Repository();
 
 	void add(const Dog& dog, int index = -1);
 	void remove(const Dog& dog);
 	void update(const Dog& oldDog, const Dog& newDog);
+	void removeAt(const int& index, const Dog& dog);
+	void updateAt(const int& index, const Dog& oldDog, const Dog& newDog);
+
+	void beginBatch();
+	void endBatch();
+
+	void compact();
+	void waitForCompaction();
+	void flush();
+
+	void save();
+	void importFrom(const std::string& fileName);
+	void exportTo(const std::string& fileName, const StorageFormat& format) const;
 
 	int indexOf(const Dog& dog) const;
-	Dog& findByNameAndBreed(const std::string& name, const std::string& breed);
-	
-	std::vector<Dog>& getDogs() { return this->dogs; };
-	Dog& operator[](const int& index) { return this->dogs[index]; };
+	int indexOfId(const uint64_t& id) const;
+	const Dog& findById(const uint64_t& id) const;
+	const Dog& findByNameAndBreed(const std::string& name, const std::string& breed) const;
+	std::vector<int> filterByBreedAndAge(const std::string& breed, const int& age) const;
+	std::vector<int> search(const std::string& text, const bool& ignoreCase = false) const;
+
+	void sort(Comparator<Dog>* comparator);
+	void clear();
+
+	const std::vector<Dog>& getDogs() const { return this->dogs; };
+	const Dog& operator[](const int& index) const { return this->dogs[index]; };
 
 	int size() const { return static_cast<int>(this->dogs.size()); };
+	uint64_t getVersion() const { return this->version; }
 	void setFileName(const std::string& fileName) { this->fileName = fileName; }
+	void setPersistenceWorker(PersistenceWorker* worker) { this->worker = worker; }
+	void setBackups(const int& backups) { this->backups = backups; }
+
+	StorageFormat getFormat() const { return this->format; }
+	void setFormat(const StorageFormat& format) { this->format = format; }
+};
+
+// Keeps a batch of a repository open while it is in scope, see
+// Repository::beginBatch. The batch ends even when an exception leaves
+// the scope, only end reports a failure to write the batch.
+class RepositoryBatch
+{
+private:
+	Repository& repo;
+	bool open = true;
+
+public:
+	RepositoryBatch(Repository& repo);
+	~RepositoryBatch();
+
+	RepositoryBatch(const RepositoryBatch&) = delete;
+	RepositoryBatch& operator=(const RepositoryBatch&) = delete;
+
+	void end();
 };
@@ -1,5 +1,64 @@
 #include <algorithm>
+#include <unordered_map>
 #include "Service.h"
+#include "Config.h"
+
+/// <summary>
+/// Creates an operation that adds a dog
+/// </summary>
+/// <param name="name">the name of the dog</param>
+/// <param name="breed">the breed of the dog</param>
+/// <param name="age">the age of the dog</param>
+/// <param name="photograph">the photograph of the dog</param>
+/// <returns>the operation</returns>
+BatchOperation BatchOperation::add(const std::string& name, const std::string& breed, const int& age, const std::string& photograph)
+{
+	return BatchOperation{ OperationType::Add, name, breed, Dog{ name, breed, age, photograph } };
+}
+
+/// <summary>
+/// Creates an operation that removes a dog
+/// </summary>
+/// <param name="name">the name of the dog</param>
+/// <param name="breed">the breed of the dog</param>
+/// <returns>the operation</returns>
+BatchOperation BatchOperation::remove(const std::string& name, const std::string& breed)
+{
+	return BatchOperation{ OperationType::Remove, name, breed, Dog{} };
+}
+
+/// <summary>
+/// Creates an operation that updates a dog
+/// </summary>
+/// <param name="oldName">the old name of the dog</param>
+/// <param name="oldBreed">the old breed of the dog</param>
+/// <param name="name">the name of the dog</param>
+/// <param name="breed">the breed of the dog</param>
+/// <param name="age">the age of the dog</param>
+/// <param name="photograph">the photograph of the dog</param>
+/// <returns>the operation</returns>
+BatchOperation BatchOperation::update(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph)
+{
+	return BatchOperation{ OperationType::Update, oldName, oldBreed, Dog{ name, breed, age, photograph } };
+}
+
+/// <summary>
+/// Creates an operation that undoes the last operation
+/// </summary>
+/// <returns>the operation</returns>
+BatchOperation BatchOperation::undo()
+{
+	return BatchOperation{ OperationType::Undo, "", "", Dog{} };
+}
+
+/// <summary>
+/// Creates an operation that redoes the last undone operation
+/// </summary>
+/// <returns>the operation</returns>
+BatchOperation BatchOperation::redo()
+{
+	return BatchOperation{ OperationType::Redo, "", "", Dog{} };
+}
 
 /// <summary>
 /// Constructs the Service class
@@ -8,7 +67,8 @@
 /// <param name="adoptionList">the adoption list</param>
 /// <param name="validator">the validator</param>
 /// <param name="generate">whether or not to generate 10 startup entries</param>
-Service::Service(Repository& repo, AdoptionList* adoptionList, DogValidator& validator, bool generate) : repo{ repo }, adoptionList{ adoptionList }, validator { validator }
+Service::Service(Repository& repo, AdoptionList* adoptionList, DogValidator& validator, bool generate) : repo{ repo }, adoptionList{ adoptionList }, validator { validator },
+	history{ ActionContext{ repo, nullptr, adoptionList }, "Dogs.history", Config::getHistoryEntries(), Config::getHistoryBytes() }
 {
 	if (generate)
 	{
@@ -39,9 +99,9 @@ void Service::add(const std::string& name, const std::string& breed, const int&
 	this->validator.validate(dog);
 	this->repo.add(dog);
 
-	std::unique_ptr<Action> p = std::make_unique<ActionAdd>(dog, repo, this->repo.size());
-	undoStack.push_back(std::move(p));
-	redoStack.clear();
+	// the action keeps the dog with the id the repository gave it
+	int index = this->repo.size() - 1;
+	this->history.record(std::make_unique<ActionAdd>(this->repo[index], repo, index));
 }
 
 /// <summary>
@@ -53,11 +113,9 @@ void Service::remove(const std::string& name, const std::string& breed)
 {
 	Dog dog = this->repo.findByNameAndBreed(name, breed);
 	int index = repo.indexOf(dog);
-	this->repo.remove(dog);
+	this->repo.removeAt(index, dog);
 
-	std::unique_ptr<Action> p = std::make_unique<ActionRemove>(dog, repo, index);
-	undoStack.push_back(std::move(p));
-	redoStack.clear();
+	this->history.record(std::make_unique<ActionRemove>(dog, repo, index));
 }
 
 /// <summary>
@@ -75,48 +133,150 @@ void Service::update(const std::string& oldName, const std::string& oldBreed, co
 	this->validator.validate(newDog);
 
 	Dog oldDog = repo.findByNameAndBreed(oldName, oldBreed);
-	this->repo.update(oldDog, newDog);
+	int index = this->repo.indexOf(oldDog);
+	newDog.setId(oldDog.getId());
+	this->repo.updateAt(index, oldDog, newDog);
 
-	std::unique_ptr<Action> p = std::make_unique<ActionUpdate>(oldDog, newDog, repo);
-	undoStack.push_back(std::move(p));
-	redoStack.clear();
+	this->history.record(std::make_unique<ActionUpdate>(oldDog, newDog, repo, index));
 }
 
 /// <summary>
-/// Filter the dogs based on a given breed and age
+/// Applies a list of mutations as a single operation: everything is
+/// validated first, the file is written once and one undo step is recorded
 /// </summary>
-/// <param name="breed">the breed to filter by</param>
-/// <param name="age">the age to filter by</param>
-/// <returns>the filtered repo</returns>
-Repository Service::filterByBreedAndAge(const std::string& breed, const int& age)
+/// <param name="operations">the mutations to apply, in order</param>
+void Service::applyBatch(const std::vector<BatchOperation>& operations)
 {
-	Repository newRepo;
+	// validate the data of every dog before touching the repository
+	std::string errors;
+	for (size_t i = 0; i < operations.size(); i++)
+	{
+		if (operations[i].type != OperationType::Add && operations[i].type != OperationType::Update)
+			continue;
 
-	for (const Dog& dog : this->repo.getDogs())
+		try
+		{
+			this->validator.validate(operations[i].dog);
+		}
+		catch (DogException& e)
+		{
+			errors.append("Operation " + std::to_string(i + 1) + ": " + e.getErrors() + "\n");
+		}
+	}
+
+	if (errors.size() > 0)
+		throw DogException(errors.erase(errors.length() - 1));
+
+	// check the existence of the dogs against the repository
+	// as it will look after the previous operations
+	std::unordered_map<DogKey, bool, DogKeyHash> present;
+	auto exists = [this, &present](const DogKey& key)
 	{
-		if ((breed.length() == 0 || dog.getBreed().compare(breed) == 0) && dog.getAge() < age)
-			newRepo.add(dog);
+		auto it = present.find(key);
+		if (it != present.end())
+			return it->second;
+
+		return this->repo.indexOf(Dog{ key.first, key.second, 0, "" }) != -1;
+	};
+
+	for (const BatchOperation& operation : operations)
+	{
+		DogKey key{ operation.name, operation.breed };
+		DogKey newKey{ operation.dog.getName(), operation.dog.getBreed() };
+
+		switch (operation.type)
+		{
+		case OperationType::Add:
+			if (exists(newKey))
+				throw DuplicateDogException{};
+			present[newKey] = true;
+			break;
+		case OperationType::Remove:
+			if (!exists(key))
+				throw InexistenDogException{};
+			present[key] = false;
+			break;
+		case OperationType::Update:
+			if (!exists(key))
+				throw InexistenDogException{};
+			if (newKey != key && exists(newKey))
+				throw DuplicateDogException{};
+			present[key] = false;
+			present[newKey] = true;
+			break;
+		case OperationType::Undo:
+		case OperationType::Redo:
+			throw RepositoryException("A batch cannot undo or redo!");
+		}
+	}
+
+	std::vector<std::unique_ptr<Action>> actions;
+	actions.reserve(operations.size());
+	RepositoryBatch batch{ this->repo };
+
+	try
+	{
+		for (const BatchOperation& operation : operations)
+		{
+			if (operation.type == OperationType::Add)
+			{
+				this->repo.add(operation.dog);
+				int index = this->repo.size() - 1;
+				actions.push_back(std::make_unique<ActionAdd>(this->repo[index], repo, index));
+			}
+			else if (operation.type == OperationType::Remove)
+			{
+				Dog dog = this->repo.findByNameAndBreed(operation.name, operation.breed);
+				int index = this->repo.indexOf(dog);
+				this->repo.removeAt(index, dog);
+				actions.push_back(std::make_unique<ActionRemove>(dog, repo, index));
+			}
+			else
+			{
+				Dog oldDog = this->repo.findByNameAndBreed(operation.name, operation.breed);
+				Dog newDog = operation.dog;
+				newDog.setId(oldDog.getId());
+				int index = this->repo.indexOf(oldDog);
+				this->repo.updateAt(index, oldDog, newDog);
+				actions.push_back(std::make_unique<ActionUpdate>(oldDog, newDog, repo, index));
+			}
+		}
 	}
+	catch (...)
+	{
+		// roll back what was applied so the batch stays atomic,
+		// the batch ends even if the rollback fails as well
+		for (auto it = actions.rbegin(); it != actions.rend(); ++it)
+			(*it)->executeUndo();
+
+		throw;
+	}
+
+	batch.end();
+
+	this->history.record(std::make_unique<ActionBatch>(std::move(actions), repo));
+}
 
-	return newRepo;
+/// <summary>
+/// Filter the dogs based on a given breed and age
+/// </summary>
+/// <param name="breed">the breed to filter by</param>
+/// <param name="age">the age to filter by</param>
+/// <returns>a view of the matching dogs</returns>
+DogView Service::filterByBreedAndAge(const std::string& breed, const int& age)
+{
+	return DogView{ this->repo, this->repo.filterByBreedAndAge(breed, age) };
 }
 
 /// <summary>
-/// Filter the dogs based on a given name
+/// Filter the dogs based on a given name or breed
 /// </summary>
 /// <param name="text">the string to filter by</param>
-/// <returns>the filtered repo</returns>
-Repository Service::filterByString(const std::string& text)
+/// <param name="ignoreCase">true to ignore the case of the letters</param>
+/// <returns>a view of the matching dogs</returns>
+DogView Service::filterByString(const std::string& text, const bool& ignoreCase)
 {
-	Repository newRepo;
-
-	for (const Dog& dog : this->repo.getDogs())
-	{
-		if (dog.getName().find(text) != std::string::npos) // || dog.getBreed().find(text) != std::string::npos)
-			newRepo.add(dog);
-	}
-
-	return newRepo;
+	return DogView{ this->repo, this->repo.search(text, ignoreCase) };
 }
 
 /// <summary>
@@ -134,29 +294,73 @@ void Service::adopt(const Dog& dog)
 /// </summary>
 void Service::undo()
 {
-	if (undoStack.size() == 0)
+	this->undo(1);
+}
+
+/// <summary>
+/// Redo the previous operation
+/// </summary>
+void Service::redo()
+{
+	this->redo(1);
+}
+
+/// <summary>
+/// Undo the last operations, the file is written once for all of them
+/// </summary>
+/// <param name="steps">how many operations to undo</param>
+/// <returns>how many operations were undone, less than steps
+///			 if the history ran out</returns>
+int Service::undo(const int& steps)
+{
+	if (!this->history.canUndo())
 		throw UndoException("There is nothing to undo!");
 
-	std::unique_ptr<Action> action = std::move(undoStack.back());
-	undoStack.pop_back();
+	int done = 0;
+	RepositoryBatch batch{ this->repo };
+
+	while (done < steps)
+	{
+		std::unique_ptr<Action> action = this->history.takeUndo();
+		if (action == nullptr)
+			break;
+
+		action.get()->executeUndo();
+		this->history.pushRedo(std::move(action));
+		done++;
+	}
 
-	action.get()->executeUndo();
-	redoStack.push_back(std::move(action));
+	batch.end();
+	return done;
 }
 
 /// <summary>
-/// Redo the previous operation
+/// Redo the last undone operations, the file is written once for all of them
 /// </summary>
-void Service::redo()
+/// <param name="steps">how many operations to redo</param>
+/// <returns>how many operations were redone, less than steps
+///			 if the history ran out</returns>
+int Service::redo(const int& steps)
 {
-	if (redoStack.size() == 0)
+	if (!this->history.canRedo())
 		throw RedoException("There is nothing to redo!");
 
-	std::unique_ptr<Action> action = std::move(redoStack.back());
-	redoStack.pop_back();
+	int done = 0;
+	RepositoryBatch batch{ this->repo };
+
+	while (done < steps)
+	{
+		std::unique_ptr<Action> action = this->history.takeRedo();
+		if (action == nullptr)
+			break;
+
+		action.get()->executeRedo();
+		this->history.pushUndo(std::move(action));
+		done++;
+	}
 
-	action.get()->executeRedo();
-	undoStack.push_back(std::move(action));
+	batch.end();
+	return done;
 }
 
 /// <summary>
@@ -164,6 +368,5 @@ void Service::redo()
 /// </summary>
 void Service::clearUndoRedo()
 {
-	undoStack.clear();
-	redoStack.clear();
+	this->history.clear();
 }
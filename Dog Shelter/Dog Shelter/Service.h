@@ -3,9 +3,39 @@
 #include <vector>
 #include <string>
 #include "Repository.h"
+#include "DogView.h"
 #include "AdoptionList.h"
 #include "Validator.h"
 #include "Action.h"
+#include "History.h"
+
+enum class OperationType
+{
+	Add,
+	Remove,
+	Update,
+	// only run one at a time, see CommandDispatcher, a batch rejects them
+	Undo,
+	Redo
+};
+
+#define OPERATION_TYPES 5
+
+// a single mutation of a batch or a command of a view, name and breed
+// identify the dog to remove or update, dog holds the data to add or update
+struct BatchOperation
+{
+	OperationType type;
+	std::string name;
+	std::string breed;
+	Dog dog;
+
+	static BatchOperation add(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
+	static BatchOperation remove(const std::string& name, const std::string& breed);
+	static BatchOperation update(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
+	static BatchOperation undo();
+	static BatchOperation redo();
+};
 
 class Service
 {
@@ -14,8 +44,7 @@ private:
 	AdoptionList* adoptionList;
 	DogValidator& validator;
 
-	std::vector<std::unique_ptr<Action>> undoStack;
-	std::vector<std::unique_ptr<Action>> redoStack;
+	History history;
 
 public:
 	Service(Repository& repo, AdoptionList* adoptionList, DogValidator& validator, bool generate = false);
@@ -24,13 +53,16 @@ public:
 	void add(const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
 	void remove(const std::string& name, const std::string& breed);
 	void update(const std::string& oldName, const std::string& oldBreed, const std::string& name, const std::string& breed, const int& age, const std::string& photograph);
+	void applyBatch(const std::vector<BatchOperation>& operations);
 	
 	void undo();
 	void redo();
+	int undo(const int& steps);
+	int redo(const int& steps);
 	void clearUndoRedo();
 
-	Repository filterByBreedAndAge(const std::string& breed, const int& age);
-	Repository filterByString(const std::string& text);
+	DogView filterByBreedAndAge(const std::string& breed, const int& age);
+	DogView filterByString(const std::string& text, const bool& ignoreCase = false);
 
 	void adopt(const Dog& dog);
 	AdoptionList* getAdoptionList() { return this->adoptionList; };
@@ -0,0 +1,187 @@
+#include <unordered_map>
+#include "Snapshot.h"
+#include "Utils.h"
+
+/// <summary>
+/// Reads an unaligned little endian 32 bit value
+/// </summary>
+/// <param name="data">the address of the value</param>
+/// <returns>the value</returns>
+static uint32_t readUInt32(const char* data)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+	return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+		static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+/// <summary>
+/// Stores a 32 bit value as little endian
+/// </summary>
+/// <param name="data">the address of the value</param>
+/// <param name="value">the value</param>
+static void writeUInt32(char* data, const uint32_t& value)
+{
+	for (int i = 0; i < 4; i++)
+		data[i] = static_cast<char>(value >> (8 * i));
+}
+
+/// <summary>
+/// Appends a 32 bit value to a buffer as little endian
+/// </summary>
+/// <param name="buffer">the buffer receiving the value</param>
+/// <param name="value">the value</param>
+static void appendUInt32(std::string& buffer, const uint32_t& value)
+{
+	char bytes[4];
+	writeUInt32(bytes, value);
+	buffer.append(bytes, sizeof(bytes));
+}
+
+/// <summary>
+/// Checks whether a buffer holds a binary snapshot
+/// </summary>
+/// <param name="data">the contents of the file</param>
+/// <returns>true if the buffer starts with the snapshot magic,
+///			 false, otherwise</returns>
+bool Snapshot::isSnapshot(std::string_view data)
+{
+	return data.size() >= SNAPSHOT_HEADER_SIZE && data.substr(0, 4) == SNAPSHOT_MAGIC;
+}
+
+/// <summary>
+/// Encodes the dogs as a binary snapshot
+/// </summary>
+/// <param name="dogs">the dogs to encode</param>
+/// <returns>the contents of the snapshot file</returns>
+std::string Snapshot::encode(const std::vector<Dog>& dogs)
+{
+	std::string records;
+	std::string strings;
+	std::unordered_map<std::string_view, uint32_t> offsets;
+	records.reserve(dogs.size() * SNAPSHOT_RECORD_SIZE);
+
+	auto appendString = [&](std::string_view value)
+	{
+		appendUInt32(records, static_cast<uint32_t>(strings.size()));
+		appendUInt32(records, static_cast<uint32_t>(value.size()));
+		strings.append(value);
+	};
+
+	// breeds repeat heavily so each one is stored only once,
+	// the views point into the dogs, which outlive the map
+	auto appendBreed = [&](std::string_view value)
+	{
+		auto it = offsets.find(value);
+		if (it == offsets.end())
+		{
+			it = offsets.emplace(value, static_cast<uint32_t>(strings.size())).first;
+			strings.append(value);
+		}
+
+		appendUInt32(records, it->second);
+		appendUInt32(records, static_cast<uint32_t>(value.size()));
+	};
+
+	for (const Dog& dog : dogs)
+	{
+		appendString(dog.getName());
+		appendBreed(dog.getBreed());
+		appendString(dog.getPhotohraph());
+		appendUInt32(records, static_cast<uint32_t>(dog.getAge()));
+		appendUInt32(records, static_cast<uint32_t>(dog.getId()));
+		appendUInt32(records, static_cast<uint32_t>(dog.getId() >> 32));
+	}
+
+	std::string data{ SNAPSHOT_MAGIC };
+	data.reserve(SNAPSHOT_HEADER_SIZE + records.size() + strings.size());
+
+	appendUInt32(data, SNAPSHOT_VERSION);
+	appendUInt32(data, static_cast<uint32_t>(dogs.size()));
+	appendUInt32(data, static_cast<uint32_t>(strings.size()));
+	appendUInt32(data, 0);
+
+	data.append(records);
+	data.append(strings);
+
+	uint32_t checksum = crc32(std::string_view{ data }.substr(SNAPSHOT_HEADER_SIZE));
+	writeUInt32(&data[16], checksum);
+
+	return data;
+}
+
+/// <summary>
+/// Validates the header and the checksum of a snapshot,
+/// version 1 snapshots are read with every id left at 0
+/// </summary>
+/// <param name="data">the contents of the file, must outlive the reader</param>
+SnapshotReader::SnapshotReader(std::string_view data)
+{
+	if (!Snapshot::isSnapshot(data))
+		return;
+
+	uint32_t version = readUInt32(data.data() + 4);
+	if (version == 1)
+		this->recordSize = SNAPSHOT_V1_RECORD_SIZE;
+	else if (version != SNAPSHOT_VERSION)
+		return;
+
+	this->count = readUInt32(data.data() + 8);
+	this->stringsSize = readUInt32(data.data() + 12);
+	uint32_t checksum = readUInt32(data.data() + 16);
+
+	std::string_view body = data.substr(SNAPSHOT_HEADER_SIZE);
+	if (body.size() != static_cast<uint64_t>(this->count) * this->recordSize + this->stringsSize)
+		return;
+
+	if (crc32(body) != checksum)
+		return;
+
+	this->records = body.data();
+	this->strings = body.data() + static_cast<size_t>(this->count) * this->recordSize;
+	this->valid = true;
+}
+
+/// <summary>
+/// Resolves an (offset, length) field of a record in the string table
+/// </summary>
+/// <param name="field">the address of the field</param>
+/// <param name="value">receives a view of the string</param>
+/// <returns>true if the string is inside the table,
+///			 false, otherwise</returns>
+bool SnapshotReader::readString(const char* field, std::string_view& value) const
+{
+	uint32_t offset = readUInt32(field);
+	uint32_t length = readUInt32(field + 4);
+	if (static_cast<uint64_t>(offset) + length > this->stringsSize)
+		return false;
+
+	value = std::string_view{ this->strings + offset, length };
+	return true;
+}
+
+/// <summary>
+/// Reads a dog straight from its fixed width record
+/// </summary>
+/// <param name="index">the index of the record</param>
+/// <param name="dog">the dog receiving the data</param>
+/// <returns>true if the record is valid,
+///			 false, otherwise</returns>
+bool SnapshotReader::read(const size_t& index, Dog& dog) const
+{
+	if (!this->valid || index >= this->count)
+		return false;
+
+	const char* record = this->records + index * this->recordSize;
+
+	std::string_view name, breed, photograph;
+	if (!this->readString(record, name) || !this->readString(record + 8, breed) || !this->readString(record + 16, photograph))
+		return false;
+
+	dog.assign(name, breed, static_cast<int32_t>(readUInt32(record + 24)), photograph);
+
+	uint64_t id = 0;
+	if (this->recordSize == SNAPSHOT_RECORD_SIZE)
+		id = readUInt32(record + 28) | static_cast<uint64_t>(readUInt32(record + 32)) << 32;
+	dog.setId(id);
+	return true;
+}
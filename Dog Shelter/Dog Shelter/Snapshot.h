@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Dog.h"
+
+// Binary snapshot layout (little endian):
+//   header  - magic "DOGB", version, record count, string table size, CRC32 of the rest
+//   records - one fixed width record per dog: offset and length of the name,
+//             breed and photograph in the string table, followed by the age
+//             and (since version 2) the 64 bit id of the dog
+//   strings - the strings of every record without separators, each breed is stored once
+#define SNAPSHOT_MAGIC "DOGB"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_HEADER_SIZE 20
+#define SNAPSHOT_RECORD_SIZE 36
+// the records of version 1 snapshots, which have no ids
+#define SNAPSHOT_V1_RECORD_SIZE 28
+
+class Snapshot
+{
+public:
+	static bool isSnapshot(std::string_view data);
+	static std::string encode(const std::vector<Dog>& dogs);
+};
+
+class SnapshotReader
+{
+private:
+	const char* records = nullptr;
+	const char* strings = nullptr;
+	uint32_t count = 0;
+	uint32_t stringsSize = 0;
+	uint32_t recordSize = SNAPSHOT_RECORD_SIZE;
+	bool valid = false;
+
+	bool readString(const char* field, std::string_view& value) const;
+
+public:
+	SnapshotReader(std::string_view data);
+
+	bool isValid() const { return this->valid; }
+	size_t size() const { return this->count; }
+	bool read(const size_t& index, Dog& dog) const;
+};
@@ -1,10 +1,29 @@
 #include <assert.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <limits>
 #include "Test.h"
 #include "Repository.h"
 #include "AdoptionList.h"
 #include "Service.h"
 #include "Comparator.h"
 #include "Validator.h"
+#include "Utils.h"
+#include "IncrementalFilter.h"
+#include "DiskImageCache.h"
+#include "LRUCache.h"
+#include "Config.h"
+#include "FetchScheduler.h"
+#include "Prefetcher.h"
+#include "FrameStats.h"
+#include "HTMLReport.h"
+#include "PersistenceWorker.h"
+#include "FileUtils.h"
+#include "History.h"
+#include "CommandDispatcher.h"
+#include "DogView.h"
 
 /// <summary>
 /// Tests the domain
@@ -34,6 +53,16 @@ void Test::testDomain()
 
 	dog2.setAge(4);
 	assert(dog.toString() == "jkl is a ghi of age 4");
+
+	Dog dog3;
+	assert(dog3.parse("abc,def,5,http://url"));
+	assert(dog3.getName() == "abc" && dog3.getBreed() == "def");
+	assert(dog3.getAge() == 5 && dog3.getPhotohraph() == "http://url");
+	assert(!dog3.parse("abc,def,5"));
+	assert(!dog3.parse("abc,def,x,http://url"));
+	assert(!dog3.parse("abc,def,5,http://url,extra"));
+	assert(dog3.parse("abc,def,5,http://url,42") && dog3.getId() == 42);
+	assert(dog3.parse("abc,def,5,http://url") && dog3.getId() == 0);
 }
 
 /// <summary>
@@ -121,6 +150,49 @@ void Test::testRepo()
 	{
 		assert(true);
 	}
+
+	// the index follows the dogs when they move
+	repo.add(dog1, 0);
+	assert(repo.indexOf(dog1) == 0);
+	assert(repo.indexOf(dog4) == 1);
+	assert(repo.indexOf(dog5) == 2);
+
+	repo.remove(dog4);
+	assert(repo.indexOf(dog4) == -1);
+	assert(repo.indexOf(dog5) == 1);
+
+	try
+	{
+		repo.update(dog1, dog5);
+		assert(false);
+	}
+	catch (DuplicateDogException&)
+	{
+		assert(true);
+	}
+	assert(repo.findByNameAndBreed(dog1.getName(), dog1.getBreed()) == dog1);
+
+	// the breed and age columns follow the dogs as well,
+	// the dogs of a breed share its interned string
+	Repository columns{};
+	columns.add(Dog{ "a", "pug", 2, "url" });
+	columns.add(Dog{ "b", "poodle", 5, "url" });
+	columns.add(Dog{ "c", "pug", 7, "url" });
+	columns.add(Dog{ "d", "pug", 300, "url" });
+	assert(&columns[0].getBreed() == &columns[2].getBreed());
+	assert(columns[0].getBreedId() != columns[1].getBreedId());
+	assert(static_cast<int>(Dog{}.getBreedId()) == BreedDictionary::find(""));
+	assert(BreedDictionary::find("pug") == static_cast<int>(columns[0].getBreedId()));
+	assert(BreedDictionary::find("no such breed") == -1);
+	assert(columns.filterByBreedAndAge("pug", 6) == std::vector<int>({ 0 }));
+	assert(columns.filterByBreedAndAge("", 6) == std::vector<int>({ 0, 1 }));
+	assert(columns.filterByBreedAndAge("pug", 301) == std::vector<int>({ 0, 2, 3 }));
+	assert(columns.filterByBreedAndAge("barbet", 10).empty());
+
+	columns.remove(Dog{ "a", "pug", 2, "url" });
+	columns.update(Dog{ "b", "poodle", 5, "url" }, Dog{ "b", "pug", 1, "url" });
+	assert(columns.filterByBreedAndAge("pug", 6) == std::vector<int>({ 0 }));
+	assert(columns.filterByBreedAndAge("poodle", 6).empty());
 }
 
 /// <summary>
@@ -223,6 +295,1254 @@ void Test::testServ()
 	delete adoptionList;
 }
 
+/// <summary>
+/// Tests the batch operations of the service
+/// </summary>
+void Test::testBatch()
+{
+	Repository repo{};
+	AdoptionList* adoptionList = new CSVAdoptionList;
+	DogValidator validator{};
+	Service serv{ repo, adoptionList, validator };
+
+	serv.add("def", "abc", 3, "http1");
+
+	serv.applyBatch({
+		BatchOperation::add("jkl", "ghi", 4, "http2"),
+		BatchOperation::add("gsd", "fad", 5, "http3"),
+		BatchOperation::update("def", "abc", "xyz", "abc", 6, "http4"),
+		BatchOperation::remove("jkl", "ghi")
+		});
+
+	assert(repo.size() == 2);
+	assert(repo[0].getName() == "xyz");
+	assert(repo[1].getName() == "gsd");
+
+	// an invalid dog rejects the whole batch
+	try
+	{
+		serv.applyBatch({ BatchOperation::add("abcd", "efgh", 1, "http5"), BatchOperation::add("a", "b", 1, "c") });
+		assert(false);
+	}
+	catch (DogException&)
+	{
+		assert(true);
+	}
+	assert(repo.size() == 2);
+
+	// so does a dog that would not exist by then
+	try
+	{
+		serv.applyBatch({ BatchOperation::remove("gsd", "fad"), BatchOperation::update("gsd", "fad", "gsd", "fad", 1, "http6") });
+		assert(false);
+	}
+	catch (InexistenDogException&)
+	{
+		assert(true);
+	}
+	assert(repo.size() == 2);
+
+	// undo and redo only run as commands of their own
+	try
+	{
+		serv.applyBatch({ BatchOperation::add("abcd", "efgh", 1, "http5"), BatchOperation::undo() });
+		assert(false);
+	}
+	catch (RepositoryException&)
+	{
+		assert(true);
+	}
+	assert(repo.size() == 2);
+
+	// the whole batch is undone and redone in one step
+	serv.undo();
+	assert(repo.size() == 1);
+	assert(repo[0].getName() == "def");
+
+	serv.redo();
+	assert(repo.size() == 2);
+	assert(repo.indexOf(Dog{ "xyz", "abc", 6, "http4" }) != -1);
+
+	delete adoptionList;
+
+	// a batch left by an exception still ends and writes what it holds
+	std::string fileName = "BatchScope.txt";
+	std::ofstream{ fileName }.close();
+	{
+		Repository file{ false, fileName };
+		try
+		{
+			RepositoryBatch batch{ file };
+			file.add(Dog{ "abc", "def", 1, "http1" });
+			assert(Repository(true, fileName).size() == 0);
+			throw InexistenDogException{};
+		}
+		catch (InexistenDogException&)
+		{
+			assert(true);
+		}
+		assert(Repository(true, fileName).size() == 1);
+
+		file.add(Dog{ "ghi", "jkl", 2, "http2" });
+		assert(Repository(true, fileName).size() == 2);
+	}
+	std::remove(fileName.c_str());
+}
+
+/// <summary>
+/// Tests the journaled repository
+/// </summary>
+void Test::testJournal()
+{
+	std::string fileName = "TestDogs.txt";
+	std::ofstream{ fileName }.close();
+
+	{
+		Repository repo{ true, fileName, true };
+		repo.add(Dog{ "def", "abc", 3, "url1" });
+		repo.add(Dog{ "jkl", "ghi", 4, "url2" });
+		repo.add(Dog{ "gsd", "fad", 5, "url3" }, 0);
+		repo.update(Dog{ "def", "abc", 3, "url1" }, Dog{ "xyz", "abc", 6, "url4" });
+		repo.remove(Dog{ "jkl", "ghi", 4, "url2" });
+	}
+
+	// the journal is replayed on top of the (still empty) file
+	{
+		Repository repo{ true, fileName, true };
+		assert(repo.size() == 2);
+		assert(repo[0].getName() == "gsd");
+		assert(repo[1].getName() == "xyz" && repo[1].getAge() == 6);
+
+		repo.compact();
+		repo.waitForCompaction();
+		repo.add(Dog{ "abc", "def", 1, "url5" });
+	}
+
+	// the compacted file plus the fresh journal
+	{
+		Repository repo{ true, fileName, true };
+		assert(repo.size() == 3);
+		assert(repo[2].getName() == "abc");
+	}
+
+	std::remove(fileName.c_str());
+	std::remove((fileName + ".journal").c_str());
+}
+
+/// <summary>
+/// Tests the binary snapshot format
+/// </summary>
+void Test::testSnapshot()
+{
+	std::string textName = "TestDogs.txt";
+	std::string binaryName = "TestDogs.bin";
+
+	assert(crc32("123456789") == 0xCBF43926u);
+
+	Repository repo{};
+	repo.add(Dog{ "def", "abc", 3, "url1" });
+	repo.add(Dog{ "jkl", "abc", 4, "url2" });
+	repo.add(Dog{ "gsd", "fad", 5, "url3" });
+	repo.exportTo(textName, StorageFormat::Text);
+	repo.exportTo(binaryName, StorageFormat::Binary);
+
+	// the numbers are little endian whatever the machine
+	{
+		std::ifstream f(binaryName, std::ios::binary);
+		char header[12];
+		f.read(header, sizeof(header));
+		assert(std::string(header, sizeof(header)) == std::string("DOGB\x02\0\0\0\x03\0\0\0", sizeof(header)));
+	}
+
+	{
+		Repository binary{ true, binaryName };
+		assert(binary.getFormat() == StorageFormat::Binary);
+		assert(binary.size() == 3);
+		assert(binary[1].getName() == "jkl" && binary[1].getBreed() == "abc");
+		assert(binary[2].getAge() == 5 && binary[2].getPhotohraph() == "url3");
+
+		// the repository keeps the format of the file it opened
+		binary.remove(Dog{ "def", "abc", 3, "url1" });
+	}
+
+	{
+		Repository binary{ true, binaryName };
+		assert(binary.getFormat() == StorageFormat::Binary);
+		assert(binary.size() == 2);
+
+		binary.importFrom(textName);
+		assert(binary.size() == 3);
+	}
+
+	{
+		Repository text{ true, textName };
+		assert(text.getFormat() == StorageFormat::Text);
+		assert(text.size() == 3);
+	}
+
+	// flip a byte of the string table
+	{
+		std::fstream f(binaryName, std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(-1, std::ios::end);
+		f.put('#');
+	}
+
+	try
+	{
+		Repository binary{ true, binaryName };
+		assert(false);
+	}
+	catch (FileException&)
+	{
+		assert(true);
+	}
+
+	std::remove(textName.c_str());
+	std::remove(binaryName.c_str());
+}
+
+/// <summary>
+/// Tests the incremental filter
+/// </summary>
+void Test::testFilter()
+{
+	Repository repo{};
+	repo.add(Dog{ "max", "pug", 2, "url" });
+	repo.add(Dog{ "maxine", "pug", 3, "url" });
+	repo.add(Dog{ "rex", "pug", 4, "url" });
+	repo.add(Dog{ "bella", "pug", 5, "url" });
+
+	IncrementalFilter filter{ repo };
+	assert(filter.filter("") == std::vector<int>({ 0, 1, 2, 3 }));
+	assert(filter.filter("x") == std::vector<int>({ 0, 1, 2 }));
+	assert(filter.getLastScanned() == 4);
+
+	// extending the query only looks at the previous matches
+	assert(filter.filter("xi") == std::vector<int>({ 1 }));
+	assert(filter.getLastScanned() == 3);
+
+	// a shorter query needs a full scan
+	assert(filter.filter("ma") == std::vector<int>({ 0, 1 }));
+	assert(filter.getLastScanned() == 4);
+
+	// so does a query over a modified repo
+	repo.add(Dog{ "mara", "pug", 6, "url" });
+	assert(filter.filter("mar") == std::vector<int>({ 4 }));
+	assert(filter.getLastScanned() == 5);
+}
+
+/// <summary>
+/// Tests the substring search
+/// </summary>
+void Test::testSearch()
+{
+	Repository repo{};
+	repo.add(Dog{ "Maxwell", "Beagle", 2, "url" });
+	repo.add(Dog{ "rex", "maltese", 3, "url" });
+	repo.add(Dog{ "bella", "Poodle", 4, "url" });
+
+	// the index is built on the first search
+	assert(repo.search("max") == std::vector<int>());
+	assert(repo.search("max", true) == std::vector<int>({ 0 }));
+	assert(repo.search("eagl") == std::vector<int>({ 0 }));
+	assert(repo.search("el") == std::vector<int>({ 0, 2 }));
+	assert(repo.search("").size() == 3);
+
+	// and maintained by every mutation afterwards
+	repo.add(Dog{ "maximus", "pug", 5, "url" }, 0);
+	assert(repo.search("MAX", true) == std::vector<int>({ 0, 1 }));
+
+	repo.remove(Dog{ "Maxwell", "Beagle", 2, "url" });
+	assert(repo.search("max", true) == std::vector<int>({ 0 }));
+	assert(repo.search("beagle").empty());
+	assert(repo.search("bella") == std::vector<int>({ 2 }));
+
+	repo.update(Dog{ "rex", "maltese", 3, "url" }, Dog{ "maxie", "maltese", 3, "url" });
+	assert(repo.search("max") == std::vector<int>({ 0, 1 }));
+	assert(repo.search("rex").empty());
+
+	Comparator<Dog>* comp = new ComparatorAscendingByName{};
+	repo.sort(comp);
+	assert(repo.search("max") == std::vector<int>({ 1, 2 }));
+	delete comp;
+}
+
+// records the notifications of a repository
+class RecordingObserver : public Observer
+{
+public:
+	std::vector<std::string> calls;
+
+	void beforeInsert(const int& index) override { calls.push_back("+" + std::to_string(index)); }
+	void afterInsert(const int& index) override { calls.push_back("+" + std::to_string(index) + "!"); }
+	void beforeRemove(const int& index) override { calls.push_back("-" + std::to_string(index)); }
+	void afterRemove(const int& index) override { calls.push_back("-" + std::to_string(index) + "!"); }
+	void afterUpdate(const int& index) override { calls.push_back("~" + std::to_string(index) + "!"); }
+	void beforeReset() override { calls.push_back("*"); }
+	void afterReset() override { calls.push_back("*!"); }
+};
+
+/// <summary>
+/// Tests the change notifications
+/// </summary>
+void Test::testObserver()
+{
+	Repository repo{};
+	RecordingObserver observer{};
+	repo.addObserver(&observer);
+
+	Dog dog1{ "rex", "pug", 2, "url" };
+	Dog dog2{ "max", "pug", 3, "url" };
+	repo.add(dog1);
+	repo.add(dog2, 0);
+	repo.update(dog1, Dog{ "rex", "pug", 4, "url" });
+	repo.remove(dog2);
+
+	Comparator<Dog>* comp = new ComparatorAscendingByName{};
+	repo.sort(comp);
+	delete comp;
+
+	assert(observer.calls == std::vector<std::string>({ "+0", "+0!", "+0", "+0!", "~1!", "-0", "-0!", "*", "*!" }));
+
+	// copies are not observed
+	Repository copy = repo;
+	copy.add(dog2);
+	assert(observer.calls.size() == 9);
+
+	repo.removeObserver(&observer);
+	repo.add(dog2);
+	assert(observer.calls.size() == 9);
+
+	// the adoption list notifies the same way
+	RecordingObserver adoptionObserver{};
+	AdoptionList* adoptionList = new CSVAdoptionList;
+	adoptionList->addObserver(&adoptionObserver);
+
+	adoptionList->add(dog1);
+	adoptionList->update(dog1, Dog{ "rex", "pug", 5, "url" });
+	adoptionList->remove(dog2);
+	adoptionList->remove(dog1);
+	assert(adoptionObserver.calls == std::vector<std::string>({ "+0", "+0!", "~0!", "-0", "-0!" }));
+
+	delete adoptionList;
+}
+
+/// <summary>
+/// Tests the disk image cache against a stand-in for the photograph server
+/// </summary>
+void Test::testImageCache()
+{
+	std::string directory = "TestImageCache";
+	std::filesystem::remove_all(directory);
+
+	// answers 304 when the client already has the current version,
+	// otherwise the given body, which a broken server may leave empty
+	int requests = 0;
+	auto server = [&requests](const std::string& ifNoneMatch, const std::string& body = std::string(100, 'x'))
+	{
+		requests++;
+		HttpResponse response{};
+		response.status = ifNoneMatch == "\"v1\"" ? 304 : 200;
+		if (response.status == 200)
+		{
+			response.body = body;
+			response.etag = "\"v1\"";
+			response.lastModified = "Mon, 01 Jan 2024 00:00:00 GMT";
+		}
+		return response;
+	};
+
+	std::string url = "https://example.com/dog.jpg";
+	std::string etag, lastModified, data;
+	{
+		DiskImageCache cache{ directory, 250 };
+		assert(!cache.lookup(url, data));
+		assert(!cache.validators(url, etag, lastModified));
+
+		assert(cache.resolve(url, server(""), data) == ImageResolution::Updated);
+		assert(data == std::string(100, 'x') && cache.count() == 1 && cache.size() == 100);
+	}
+
+	// a restart finds the image and revalidates it
+	{
+		DiskImageCache cache{ directory, 250 };
+		assert(cache.lookup(url, data) && data.size() == 100);
+		assert(cache.validators(url, etag, lastModified));
+
+		// the index is checked apart from the read, which may happen on another thread
+		std::string path;
+		data.clear();
+		assert(cache.locate(url, path) && DiskImageCache::readImage(path, data) && data.size() == 100);
+		assert(!cache.locate("https://example.com/a.jpg", path));
+		assert(etag == "\"v1\"" && lastModified == "Mon, 01 Jan 2024 00:00:00 GMT");
+
+		// a 304 keeps the cached copy, which was already decoded
+		data.clear();
+		assert(cache.resolve(url, server(etag), data) == ImageResolution::Cached);
+		assert(data == std::string(100, 'x') && requests == 2);
+
+		// so does an empty body, it must not replace the image
+		data.clear();
+		assert(cache.resolve(url, server("", ""), data) == ImageResolution::Cached);
+		assert(data == std::string(100, 'x') && cache.size() == 100);
+		assert(cache.resolve("https://example.com/empty.jpg", server("", ""), data) == ImageResolution::Missing);
+		assert(cache.count() == 1);
+
+		// a failed request falls back to the cached copy
+		assert(cache.resolve(url, HttpResponse{}, data) == ImageResolution::Cached);
+		assert(cache.resolve("https://example.com/other.jpg", HttpResponse{}, data) == ImageResolution::Missing);
+
+		// the least recently used image is evicted first
+		cache.store("https://example.com/a.jpg", std::string(100, 'a'), "", "");
+		assert(cache.lookup(url, data));
+		cache.store("https://example.com/b.jpg", std::string(100, 'b'), "", "");
+		assert(cache.count() == 2 && cache.size() == 200);
+		assert(cache.lookup(url, data));
+		assert(!cache.lookup("https://example.com/a.jpg", data));
+
+		// a new version replaces the cached one and is decoded again
+		assert(cache.resolve(url, server("", std::string(100, 'y')), data) == ImageResolution::Updated);
+		assert(data == std::string(100, 'y'));
+		assert(cache.lookup(url, data) && data == std::string(100, 'y'));
+
+		cache.remove(url);
+		assert(cache.count() == 1 && !cache.lookup(url, data));
+	}
+
+	std::filesystem::remove_all(directory);
+}
+
+/// <summary>
+/// Tests the byte budgeted LRU cache
+/// </summary>
+void Test::testLRUCache()
+{
+	LRUCache<std::string, std::string> cache{ 10, [](const std::string& value) { return value.size(); } };
+	cache.insert("a", "1234");
+	cache.insert("b", "1234");
+	assert(cache.size() == 8 && cache.count() == 2);
+
+	assert(cache.find("a") != nullptr);
+	assert(cache.find("c") == nullptr);
+
+	// b is the least recently used one
+	cache.insert("c", "1234");
+	assert(cache.peek("b") == nullptr && cache.peek("a") != nullptr && cache.peek("c") != nullptr);
+	assert(cache.getHits() == 1 && cache.getMisses() == 1 && cache.getEvictions() == 1);
+
+	// replacing a value frees the old one first
+	cache.insert("a", "12");
+	assert(cache.size() == 6 && cache.count() == 2);
+
+	// a value larger than the budget is kept alone
+	cache.insert("d", std::string(20, 'd'));
+	assert(cache.count() == 1 && cache.peek("d") != nullptr);
+
+	cache.setBudget(0);
+	assert(cache.count() == 1);
+	cache.erase("d");
+	assert(cache.count() == 0 && cache.size() == 0);
+
+	// the budget can be set on the command line
+	char program[] = "Dog Shelter";
+	char budget[] = "--pixmap-cache-mb=64";
+	char invalid[] = "--pixmap-cache-mb=lots";
+	char* argv[] = { program, budget, invalid };
+	Config::parse(3, argv);
+	assert(Config::getPixmapCacheBytes() == 64ull * 1024 * 1024);
+	Config::setPixmapCacheBytes(DEFAULT_PIXMAP_CACHE_MB * 1024ull * 1024);
+}
+
+/// <summary>
+/// Tests the photograph download scheduler
+/// </summary>
+void Test::testFetchScheduler()
+{
+	FetchScheduler scheduler{ 2 };
+
+	// each url is requested once
+	assert(scheduler.enqueue("a", FetchPriority::Visible));
+	assert(!scheduler.enqueue("a", FetchPriority::Visible));
+	assert(scheduler.enqueue("b", FetchPriority::Prefetch));
+	assert(scheduler.enqueue("c", FetchPriority::Visible));
+	assert(scheduler.enqueue("d", FetchPriority::Foreground));
+
+	// by priority, the newest request first, under the limit
+	assert(scheduler.start() == std::vector<std::string>({ "d", "c" }));
+	assert(scheduler.getRunning() == 2 && scheduler.getWaiting() == 2);
+	assert(scheduler.start().empty());
+
+	// a raised priority moves a waiting request ahead
+	assert(!scheduler.enqueue("b", FetchPriority::Foreground));
+	scheduler.finished("d");
+	assert(scheduler.start() == std::vector<std::string>({ "b" }));
+
+	// requests scrolled out of view are dropped, running ones have to be aborted
+	assert(scheduler.cancelOthers(FetchPriority::Visible, { "a" }) == std::vector<std::string>({ "c" }));
+	assert(scheduler.isRequested("a") && !scheduler.isRequested("c"));
+	assert(scheduler.getRunning() == 1);
+
+	// a late reply of a cancelled download changes nothing
+	scheduler.finished("c");
+	assert(scheduler.getRunning() == 1);
+
+	assert(!scheduler.cancel("a"));
+	assert(scheduler.getWaiting() == 0 && !scheduler.isRequested("a"));
+	assert(scheduler.enqueue("a", FetchPriority::Visible));
+}
+
+/// <summary>
+/// Tests the look-ahead over the browsed dogs
+/// </summary>
+void Test::testPrefetcher()
+{
+	Prefetcher prefetcher{ 3 };
+
+	// the look-ahead wraps around and never comes back to the current dog
+	assert(prefetcher.next(0, 10) == std::vector<int>({ 1, 2, 3 }));
+	assert(prefetcher.next(8, 10) == std::vector<int>({ 9, 0, 1 }));
+	assert(prefetcher.next(1, 3) == std::vector<int>({ 2, 0 }));
+	assert(prefetcher.next(0, 1).empty());
+	assert(prefetcher.next(-1, 10).empty());
+
+	prefetcher.prefetch("url1");
+	prefetcher.prefetch("url2");
+
+	prefetcher.shown("url1", true);
+	prefetcher.shown("url2", false);
+	prefetcher.shown("url3", false);
+	prefetcher.shown("url4", true);
+	assert(prefetcher.getHits() == 1);
+	assert(prefetcher.getLate() == 1);
+	assert(prefetcher.getMisses() == 1);
+	assert(prefetcher.hitRate() > 0.33 && prefetcher.hitRate() < 0.34);
+
+	// a prefetch counts only once
+	prefetcher.shown("url1", true);
+	assert(prefetcher.getHits() == 1);
+
+	char program[] = "Dog Shelter";
+	char count[] = "--prefetch-count=5";
+	char* argv[] = { program, count };
+	Config::parse(2, argv);
+	assert(Config::getPrefetchCount() == 5);
+	Config::setPrefetchCount(DEFAULT_PREFETCH_COUNT);
+}
+
+/// <summary>
+/// Tests the paint time kept per frame
+/// </summary>
+void Test::testFrameStats()
+{
+	FrameStats stats{};
+
+	// paints outside of a frame are not counted
+	stats.add(500);
+	stats.endFrame();
+	assert(stats.getFrames() == 0);
+	assert(stats.averageMicroseconds() == 0.0);
+
+	stats.beginFrame();
+	stats.add(1000);
+	stats.beginFrame();
+	stats.add(3000);
+	stats.endFrame();
+	assert(stats.getFrames() == 1);
+	assert(stats.getLast() == 4000);
+
+	stats.beginFrame();
+	stats.add(2000);
+	stats.endFrame();
+	assert(stats.getFrames() == 2);
+	assert(stats.getLast() == 2000);
+	assert(stats.getWorst() == 4000);
+	assert(stats.averageMicroseconds() == 3.0);
+}
+
+/// <summary>
+/// Tests the incremental writes of the CSV adoption list
+/// </summary>
+void Test::testAdoptionExport()
+{
+	auto readRows = []()
+	{
+		std::vector<std::string> rows;
+		std::ifstream f("Dogs.csv");
+		std::string line;
+		while (std::getline(f, line))
+			rows.push_back(line);
+		return rows;
+	};
+
+	Dog dog1{ "a", "b", 1, "url1" };
+	Dog dog2{ "c", "d", 2, "url2" };
+	Dog dog3{ "e", "f", 3, "url3" };
+
+	{
+		CSVAdoptionList adoptionList{};
+
+		// the first change replaces the old file, adoptions are appended
+		adoptionList.add(dog1);
+		adoptionList.add(dog2);
+		adoptionList.add(dog3);
+		assert(readRows() == std::vector<std::string>({ "a,b,1,url1", "c,d,2,url2", "e,f,3,url3" }));
+
+		// removals wait for the compaction, the next adoption compacts
+		adoptionList.remove(dog2);
+		assert(readRows().size() == 3);
+		adoptionList.add(dog2);
+		assert(readRows() == std::vector<std::string>({ "a,b,1,url1", "e,f,3,url3", "c,d,2,url2" }));
+
+		// so the ones after it are appended again
+		adoptionList.remove(dog2);
+		adoptionList.add(dog2, 0);
+		assert(readRows().size() == 3);
+		adoptionList.flush();
+		assert(readRows() == std::vector<std::string>({ "c,d,2,url2", "a,b,1,url1", "e,f,3,url3" }));
+		adoptionList.remove(dog2);
+		adoptionList.add(dog2);
+		Dog dog5{ "i", "j", 5, "url5" };
+		adoptionList.add(dog5);
+		assert(readRows() == std::vector<std::string>({ "a,b,1,url1", "e,f,3,url3", "c,d,2,url2", "i,j,5,url5" }));
+		adoptionList.remove(dog5);
+		adoptionList.flush();
+		assert(readRows() == std::vector<std::string>({ "a,b,1,url1", "e,f,3,url3", "c,d,2,url2" }));
+
+		adoptionList.update(dog1, Dog{ "g", "h", 4, "url4" });
+		assert(readRows()[0] == "a,b,1,url1");
+	}
+
+	// the pending changes are written when the list goes away
+	assert(readRows() == std::vector<std::string>({ "g,h,4,url4", "e,f,3,url3", "c,d,2,url2" }));
+
+	// enough pending changes compact the file
+	CSVAdoptionList adoptionList{};
+	adoptionList.add(dog1);
+	for (int i = 1; i < ADOPTION_COMPACT_THRESHOLD; i++)
+		adoptionList.update(dog1, dog1);
+	assert(readRows().size() == 1);
+	adoptionList.remove(dog1);
+	assert(readRows().empty());
+}
+
+/// <summary>
+/// Tests the paged HTML report
+/// </summary>
+void Test::testHTMLReport()
+{
+	std::string escaped;
+	HTMLReport::escape(escaped, "Tom & \"Jerry\" <3 'x'");
+	assert(escaped == "Tom &amp; &quot;Jerry&quot; &lt;3 &#39;x&#39;");
+	escaped.clear();
+	HTMLReport::escape(escaped, "plain");
+	assert(escaped == "plain");
+	escaped.clear();
+	HTMLReport::escape(escaped, "&&a>");
+	assert(escaped == "&amp;&amp;a&gt;");
+
+	std::vector<Dog> dogs;
+	for (int i = 0; i < 5; i++)
+		dogs.push_back(Dog{ "dog" + std::to_string(i), "poodle", i, "url" + std::to_string(i) });
+
+	// pages left by an earlier run with more dogs
+	std::ofstream{ "Report-4.html" }.close();
+	std::ofstream{ "Report-5.html" }.close();
+
+	HTMLReport report{ "Report", 2 };
+	assert(report.pageName(0) == "Report.html");
+	assert(report.pageName(2) == "Report-3.html");
+
+	report.write(dogs);
+	assert(report.getPages() == 3);
+	assert(report.getPagesWritten() == 3);
+	assert(!std::filesystem::exists("Report-4.html"));
+	assert(!std::filesystem::exists("Report-5.html"));
+
+	// an update changes only its page, any age fits in the row
+	dogs[2] = Dog{ "<b>", "poodle", std::numeric_limits<int>::min(), "url2" };
+	report.changed(2);
+	report.write(dogs);
+	assert(report.getPagesWritten() == 4);
+
+	std::ifstream f("Report-2.html");
+	std::string page{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+	f.close();
+	assert(page.find("<td>&lt;b&gt;</td>") != std::string::npos);
+	assert(page.find("<td>" + std::to_string(std::numeric_limits<int>::min()) + "</td>") != std::string::npos);
+	assert(page.find("href=\"Report.html\">previous") != std::string::npos);
+	assert(page.find("href=\"Report-3.html\">next") != std::string::npos);
+
+	// a removal moves the rows of the pages after it,
+	// and the page left empty goes away
+	dogs.erase(dogs.begin() + 3);
+	report.shifted(3);
+	report.write(dogs);
+	assert(report.getPages() == 2);
+	assert(report.getPagesWritten() == 5);
+	assert(!std::filesystem::exists("Report-3.html"));
+
+	// nothing changed, nothing written
+	report.write(dogs);
+	assert(report.getPagesWritten() == 5);
+
+	std::remove("Report.html");
+	std::remove("Report-2.html");
+}
+
+/// <summary>
+/// Tests the background writes of the persistence worker
+/// </summary>
+void Test::testPersistenceWorker()
+{
+	auto readFile = [](const std::string& fileName)
+	{
+		std::ifstream f(fileName, std::ios::binary);
+		return std::string{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+	};
+
+	{
+		PersistenceWorker worker{};
+
+		// the writes queued while the worker is busy are coalesced
+		std::promise<void> release;
+		std::shared_future<void> released = release.get_future().share();
+		worker.replace("slow.txt", [released]() { released.wait(); return std::string{ "slow" }; });
+		for (int i = 0; i < 100; i++)
+			worker.replace("fast.txt", [i]() { return std::to_string(i); });
+		release.set_value();
+
+		worker.flush();
+		assert(readFile("slow.txt") == "slow");
+		assert(readFile("fast.txt") == "99");
+		assert(worker.getWrites() == 2);
+		assert(worker.getCoalesced() == 99);
+
+		// appends go after the pending content, a removal drops both
+		worker.replace("fast.txt", []() { return std::string{ "a\n" }; });
+		worker.append("fast.txt", "b\n");
+		worker.flush();
+		assert(readFile("fast.txt") == "a\nb\n");
+
+		worker.remove("slow.txt");
+		worker.append("slow.txt", "c\n");
+		worker.remove("fast.txt");
+		worker.flush();
+		assert(readFile("slow.txt") == "c\n");
+		assert(!std::filesystem::exists("fast.txt"));
+		assert(!std::filesystem::exists("slow.txt.tmp"));
+
+		// a failed write is reported by the next flush
+		worker.replace("missing/file.txt", []() { return std::string{}; });
+		bool failed = false;
+		try
+		{
+			worker.flush();
+		}
+		catch (FileException&)
+		{
+			failed = true;
+		}
+		assert(failed);
+		worker.flush();
+
+		Repository repo{ false, "worker.txt" };
+		repo.setPersistenceWorker(&worker);
+		repo.add(Dog{ "a", "b", 1, "url1" });
+		repo.add(Dog{ "c", "d", 2, "url2" });
+		repo.flush();
+		assert(Repository(true, "worker.txt").size() == 2);
+
+		// the dogs are copied once for the mutations made while the worker is busy
+		std::promise<void> resume;
+		std::shared_future<void> resumed = resume.get_future().share();
+		worker.replace("slow.txt", [resumed]() { resumed.wait(); return std::string{ "slow" }; });
+		uint64_t coalesced = worker.getCoalesced();
+		repo.add(Dog{ "e", "f", 3, "url3" });
+		repo.remove(Dog{ "a", "b", 1, "url1" });
+		repo.add(Dog{ "g", "h", 4, "url4" });
+		resume.set_value();
+		repo.flush();
+		assert(worker.getCoalesced() == coalesced + 2);
+		Repository written{ true, "worker.txt" };
+		assert(written.size() == 3);
+		assert(written[0].getName() == "c" && written[2].getName() == "g");
+
+		CSVAdoptionList adoptionList{};
+		adoptionList.setPersistenceWorker(&worker);
+		adoptionList.add(Dog{ "a", "b", 1, "url1" });
+		adoptionList.add(Dog{ "c", "d", 2, "url2" });
+		adoptionList.flush();
+		assert(readFile("Dogs.csv") == "a,b,1,url1\nc,d,2,url2\n");
+
+		// the copy made on the worker leaves out the dogs appended after the table
+		std::promise<void> resumeList;
+		std::shared_future<void> resumedList = resumeList.get_future().share();
+		worker.replace("slow.txt", [resumedList]() { resumedList.wait(); return std::string{ "slow" }; });
+		adoptionList.remove(Dog{ "a", "b", 1, "url1" });
+		adoptionList.add(Dog{ "e", "f", 3, "url3" });
+		adoptionList.add(Dog{ "g", "h", 4, "url4" });
+		resumeList.set_value();
+		adoptionList.flush();
+		assert(readFile("Dogs.csv") == "c,d,2,url2\ne,f,3,url3\ng,h,4,url4\n");
+
+		// the pending writes are done before the worker stops
+		worker.replace("fast.txt", []() { return std::string{ "last" }; });
+	}
+
+	assert(readFile("fast.txt") == "last");
+
+	std::remove("slow.txt");
+	std::remove("fast.txt");
+	std::remove("worker.txt");
+}
+
+/// <summary>
+/// Tests the durable file replacement and the recovery from backups
+/// </summary>
+void Test::testFileUtils()
+{
+	auto readFile = [](const std::string& fileName)
+	{
+		std::ifstream f(fileName, std::ios::binary);
+		return std::string{ std::istreambuf_iterator<char>{ f }, std::istreambuf_iterator<char>{} };
+	};
+
+	std::string data = "a,b,1,url1\n";
+	FileUtils::appendChecksum(data);
+	assert(data.size() == 11 + FILE_CHECKSUM_SIZE);
+
+	std::string_view body;
+	assert(FileUtils::verifyChecksum(data, body) == ChecksumStatus::Valid);
+	assert(body == "a,b,1,url1\n");
+	assert(FileUtils::verifyChecksum("a,b,1,url1\n", body) == ChecksumStatus::Missing);
+	data[0] = 'x';
+	assert(FileUtils::verifyChecksum(data, body) == ChecksumStatus::Invalid);
+
+	// the older generations move down, the oldest one drops out
+	FileUtils::writeDurably("durable.txt", "1", 2);
+	FileUtils::writeDurably("durable.txt", "2", 2);
+	FileUtils::writeDurably("durable.txt", "3", 2);
+	FileUtils::writeDurably("durable.txt", "4", 2);
+	assert(readFile("durable.txt") == "4");
+	assert(readFile("durable.txt.1") == "3");
+	assert(readFile("durable.txt.2") == "2");
+	assert(!std::filesystem::exists("durable.txt.3"));
+	assert(!std::filesystem::exists("durable.txt.tmp"));
+	assert(!std::filesystem::exists("durable.txt.1.tmp"));
+
+	// a file without a checksum is left alone when no backup has one
+	assert(!FileUtils::recover("durable.txt"));
+
+	Repository repo{ false, "durable.txt" };
+	repo.setBackups(2);
+	repo.add(Dog{ "a", "b", 1, "url1" });
+	repo.add(Dog{ "c", "d", 2, "url2" });
+	repo.add(Dog{ "e", "f", 3, "url3" });
+
+	// a file cut short loses its checksum line, the newest valid generation is loaded
+	std::string torn = readFile("durable.txt");
+	{
+		std::ofstream f("durable.txt", std::ios::binary | std::ios::trunc);
+		f << torn.substr(0, torn.size() - FILE_CHECKSUM_SIZE - 4);
+	}
+	Repository recovered{ true, "durable.txt" };
+	assert(recovered.size() == 2);
+
+	// an empty file with a backup is recovered as well
+	{
+		std::ofstream f("durable.txt", std::ios::trunc);
+	}
+	assert(FileUtils::recover("durable.txt"));
+	assert(Repository(true, "durable.txt").size() == 2);
+
+	// a damaged file without a valid backup is refused
+	{
+		std::ofstream f("durable.txt", std::ios::binary | std::ios::trunc);
+		f << torn.substr(0, torn.size() - FILE_CHECKSUM_SIZE) << FILE_CHECKSUM_TAG << "00000000\n";
+	}
+	std::remove("durable.txt.1");
+	std::remove("durable.txt.2");
+	bool failed = false;
+	try
+	{
+		Repository damaged{ true, "durable.txt" };
+	}
+	catch (FileException&)
+	{
+		failed = true;
+	}
+	assert(failed);
+
+	std::remove("durable.txt");
+}
+
+/// <summary>
+/// Tests the bounded undo and redo history
+/// </summary>
+void Test::testHistory()
+{
+	Repository repo{};
+	CSVAdoptionList adoptionList{};
+	ActionContext context{ repo, nullptr, &adoptionList };
+
+	// an update keeps only the fields that changed
+	Dog before{ "a", "b", 1, "https://example.com/a.jpg" };
+	Dog after{ "a", "b", 2, "https://example.com/a.jpg" };
+	ActionUpdate update{ before, after, repo, 0 };
+	assert(update.getChanged() == UPDATE_AGE);
+	assert(update.getOldDog().getAge() == 1);
+	assert(update.getOldDog().getPhotohraph() == before.getPhotohraph());
+	assert(update.size() < 2 * (sizeof(Dog) + before.getPhotohraph().size()));
+
+	// every action survives its compact form
+	std::vector<std::unique_ptr<Action>> actions;
+	actions.push_back(std::make_unique<ActionAdd>(Dog{ "c", "d", 3, "url3" }, repo, 0));
+	actions.push_back(std::make_unique<ActionUpdate>(Dog{ "c", "d", 3, "url3" }, Dog{ "e", "d", 3, "url4" }, repo, 0));
+	ActionBatch batch{ std::move(actions), repo };
+
+	std::string record;
+	batch.encode(record);
+	std::string_view data{ record };
+	std::unique_ptr<Action> decoded = Action::decode(data, context);
+	assert(decoded != nullptr && data.empty());
+	decoded->executeRedo();
+	assert(repo.size() == 1 && repo[0].getName() == "e" && repo[0].getPhotohraph() == "url4");
+	decoded->executeUndo();
+	assert(repo.size() == 0);
+
+	// an adoption needs the dogs being shown
+	std::string adoption;
+	DogView view{ repo };
+	ActionAdopt{ before, repo, 0, view, 0, &adoptionList, 0 }.encode(adoption);
+	data = adoption;
+	assert(Action::decode(data, context) == nullptr);
+	data = std::string_view{ record }.substr(0, record.size() - 1);
+	assert(Action::decode(data, context) == nullptr);
+
+	// only the newest actions stay in memory, the others are spilled and come back
+	{
+		History history{ context, "Test.history", 3, 1024 * 1024 };
+		for (int i = 0; i < 10; i++)
+		{
+			Dog dog{ "dog" + std::to_string(i), "pug", i, "url" };
+			repo.add(dog);
+			history.record(std::make_unique<ActionAdd>(dog, repo, i));
+		}
+		assert(history.getEntries() == 3);
+		assert(history.getSpilled() == 7);
+		assert(std::filesystem::exists("Test.history.undo"));
+
+		for (int i = 0; i < 10; i++)
+		{
+			std::unique_ptr<Action> action = history.takeUndo();
+			action->executeUndo();
+			history.pushRedo(std::move(action));
+		}
+		assert(repo.size() == 0);
+		assert(!history.canUndo() && history.takeUndo() == nullptr);
+
+		for (int i = 0; i < 10; i++)
+		{
+			std::unique_ptr<Action> action = history.takeRedo();
+			action->executeRedo();
+			history.pushUndo(std::move(action));
+		}
+		assert(repo.size() == 10);
+		assert(repo[0].getName() == "dog0" && repo[9].getName() == "dog9");
+
+		// the byte budget spills as well, the newest action stays
+		History small{ context, "Small.history", 100, 1 };
+		small.record(std::make_unique<ActionRemove>(before, repo, 0));
+		small.record(std::make_unique<ActionRemove>(after, repo, 0));
+		assert(small.getEntries() == 1 && small.getSpilled() == 1);
+
+		// a new action drops what could be redone
+		history.record(std::make_unique<ActionAdd>(before, repo, 0));
+		assert(!history.canRedo());
+	}
+
+	// the logs only mean something to their run
+	assert(!std::filesystem::exists("Test.history.undo"));
+	assert(!std::filesystem::exists("Test.history.redo"));
+	assert(!std::filesystem::exists("Small.history.undo"));
+}
+
+/// <summary>
+/// Tests undoing and redoing several operations at once
+/// </summary>
+void Test::testUndoSteps()
+{
+	std::string fileName = "Steps.txt";
+	std::ofstream{ fileName }.close();
+
+	{
+		PersistenceWorker worker{};
+		Repository repo{ false, fileName };
+		repo.setPersistenceWorker(&worker);
+		AdoptionList* adoptionList = new CSVAdoptionList;
+		DogValidator validator{};
+		Service serv{ repo, adoptionList, validator };
+
+		for (int i = 0; i < 5; i++)
+			serv.add("dog" + std::to_string(i), "pug", i + 1, "http" + std::to_string(i));
+		serv.update("dog1", "pug", "dog1", "pug", 9, "http9");
+		serv.remove("dog3", "pug");
+		repo.flush();
+
+		// the whole range is written once
+		size_t submitted = worker.getWrites() + worker.getCoalesced();
+		assert(serv.undo(4) == 4);
+		repo.flush();
+		assert(worker.getWrites() + worker.getCoalesced() == submitted + 1);
+		assert(repo.size() == 3);
+		assert(repo[1].getAge() == 2);
+		assert(Repository(true, fileName).size() == 3);
+
+		// the history runs out before the steps do
+		assert(serv.undo(10) == 3);
+		assert(repo.size() == 0);
+		try
+		{
+			serv.undo(1);
+			assert(false);
+		}
+		catch (UndoException&)
+		{
+			assert(true);
+		}
+
+		assert(serv.redo(100) == 7);
+		assert(repo.size() == 4);
+		assert(repo.indexOf(Dog{ "dog3", "pug", 4, "http3" }) == -1);
+		assert(repo[1].getAge() == 9);
+		repo.flush();
+		assert(Repository(true, fileName).size() == 4);
+
+		// a position that went stale falls back to the lookup
+		repo.removeAt(0, Dog{ "dog4", "pug", 5, "http4" });
+		assert(repo.size() == 3 && repo.indexOf(Dog{ "dog4", "pug", 5, "http4" }) == -1);
+		repo.updateAt(2, Dog{ "dog0", "pug", 1, "http0" }, Dog{ "dog0", "pug", 7, "http0" });
+		assert(repo[0].getAge() == 7);
+
+		delete adoptionList;
+	}
+
+	std::remove(fileName.c_str());
+	std::remove((fileName + ".1").c_str());
+	std::remove((fileName + ".2").c_str());
+}
+
+/// <summary>
+/// Tests the ids the repository gives the dogs
+/// </summary>
+void Test::testDogIds()
+{
+	std::string textName = "IdDogs.txt";
+	std::string binaryName = "IdDogs.bin";
+	std::ofstream{ textName } << "abc,def,1,url1\nghi,jkl,2,url2\n";
+
+	uint64_t renamed = 0;
+	{
+		// the files written before the ids still load
+		Repository repo{ true, textName, true };
+		assert(repo.size() == 2);
+		assert(repo[0].getId() != 0 && repo[0].getId() != repo[1].getId());
+
+		AdoptionList* adoptionList = new CSVAdoptionList;
+		DogValidator validator{};
+		Service serv{ repo, adoptionList, validator };
+
+		// a renamed dog keeps its id
+		serv.add("mno", "pqr", 3, "http3");
+		renamed = repo[0].getId();
+		serv.update("abc", "def", "xyz", "def", 4, "http4");
+		assert(repo.findById(renamed).getName() == "xyz");
+
+		Dog stale{ "abc", "def", 1, "url1" };
+		stale.setId(renamed);
+		assert(repo.indexOf(stale) == 0);
+
+		// a removed dog comes back with its id
+		uint64_t removed = repo[1].getId();
+		serv.remove("ghi", "jkl");
+		assert(repo.indexOfId(removed) == -1);
+		serv.undo();
+		assert(repo.indexOfId(removed) == 1);
+
+		// the dogs moved by a batch are renumbered once it is looked up
+		{
+			RepositoryBatch batch{ repo };
+			repo.add(Dog{ "first", "aaa", 1, "http1" }, 0);
+			repo.add(Dog{ "second", "aaa", 1, "http1" }, 0);
+			repo.remove(Dog{ "second", "aaa", 1, "http1" });
+			batch.end();
+		}
+		assert(repo.indexOfId(removed) == 2 && repo.indexOfId(renamed) == 1);
+		assert(repo.indexOf(Dog{ "first", "aaa", 1, "http1" }) == 0);
+		repo.remove(Dog{ "first", "aaa", 1, "http1" });
+		assert(repo.indexOfId(removed) == 1 && repo.indexOfId(renamed) == 0);
+
+		// the names stay unique
+		try
+		{
+			serv.update("xyz", "def", "mno", "pqr", 5, "http5");
+			assert(false);
+		}
+		catch (DuplicateDogException&)
+		{
+			assert(true);
+		}
+
+		// the adoption list finds its dogs by id too
+		Dog adopted = repo.findById(renamed);
+		adoptionList->add(repo[1]);
+		adoptionList->add(adopted);
+		Dog older = adopted;
+		older.setAge(8);
+		adoptionList->update(stale, older);
+		assert((*adoptionList)[1].getName() == "xyz" && (*adoptionList)[1].getAge() == 8);
+		adoptionList->remove(stale);
+		assert(adoptionList->size() == 1 && (*adoptionList)[0].getName() == "ghi");
+
+		delete adoptionList;
+	}
+
+	// the journal keeps the ids, so do both file formats
+	{
+		Repository repo{ true, textName, true };
+		assert(repo.size() == 3);
+		assert(repo.findById(renamed).getName() == "xyz");
+
+		repo.save();
+		repo.exportTo(binaryName, StorageFormat::Binary);
+	}
+
+	{
+		Repository text{ true, textName };
+		Repository binary{ true, binaryName };
+		assert(text.findById(renamed).getName() == "xyz");
+		assert(binary.findById(renamed).getName() == "xyz");
+		assert(binary[2].getId() == text[2].getId());
+
+		// the new ids follow the ones that were loaded
+		binary.add(Dog{ "stu", "vwx", 1, "url6" });
+		assert(binary[3].getId() > binary[2].getId() && binary[3].getId() > renamed);
+	}
+
+	for (const std::string& fileName : { textName, textName + ".journal", textName + ".1", textName + ".2",
+		binaryName, binaryName + ".1", binaryName + ".2" })
+		std::remove(fileName.c_str());
+}
+
+/// <summary>
+/// Tests the command dispatcher
+/// </summary>
+void Test::testCommandDispatcher()
+{
+	Repository repo{};
+	AdoptionList* adoptionList = new CSVAdoptionList;
+	DogValidator validator{};
+	Service serv{ repo, adoptionList, validator };
+	CommandDispatcher dispatcher{ serv };
+
+	int scheduled = 0;
+	dispatcher.setRefreshScheduler([&scheduled]() { scheduled++; });
+
+	// the commands run before the refresh share it
+	dispatcher.submit(BatchOperation::add("def", "abc", 3, "http1"));
+	dispatcher.submit(BatchOperation::add("jkl", "ghi", 4, "http2"));
+	dispatcher.submit(BatchOperation::update("def", "abc", "xyz", "abc", 5, "http3"));
+	assert(repo.size() == 2 && repo[0].getName() == "xyz");
+	assert(scheduled == 1 && dispatcher.isRefreshPending());
+
+	dispatcher.refreshed();
+	assert(!dispatcher.isRefreshPending() && dispatcher.getRefreshes() == 1);
+
+	dispatcher.submit(BatchOperation::undo());
+	dispatcher.submit(BatchOperation::redo());
+	dispatcher.submit(BatchOperation::remove("jkl", "ghi"));
+	assert(repo.size() == 1);
+	assert(scheduled == 2);
+	dispatcher.refreshed();
+
+	// a failed command changes nothing, so it needs no refresh
+	try
+	{
+		dispatcher.submit(BatchOperation::remove("jkl", "ghi"));
+		assert(false);
+	}
+	catch (InexistenDogException&)
+	{
+		assert(true);
+	}
+	assert(!dispatcher.isRefreshPending() && scheduled == 2);
+
+	// a command submitted while another one runs waits for it
+	dispatcher.setRefreshScheduler([&dispatcher, &repo]()
+		{
+			dispatcher.submit(BatchOperation::add("mno", "pqr", 1, "http4"));
+			assert(repo.size() == 2);
+		});
+	dispatcher.submit(BatchOperation::add("stu", "vwx", 2, "http5"));
+	assert(repo.size() == 3 && repo[2].getName() == "mno");
+
+	assert(dispatcher.getStats(OperationType::Add).count == 4);
+	assert(dispatcher.getStats(OperationType::Remove).count == 1);
+	assert(dispatcher.getStats(OperationType::Undo).count == 1);
+	assert(dispatcher.getStats(OperationType::Add).worst >= dispatcher.getStats(OperationType::Add).last);
+	assert(std::string{ CommandDispatcher::nameOf(OperationType::Update) } == "update");
+
+	delete adoptionList;
+}
+
+/// <summary>
+/// Tests the views over the dogs of a repository
+/// </summary>
+void Test::testDogView()
+{
+	Repository repo{};
+	AdoptionList* adoptionList = new CSVAdoptionList;
+	DogValidator validator{};
+	Service serv{ repo, adoptionList, validator };
+
+	serv.add("def", "pug", 3, "http1");
+	serv.add("jkl", "abc", 4, "http2");
+	serv.add("gsd", "pug", 5, "http3");
+
+	DogView view = serv.filterByBreedAndAge("pug", 10);
+	assert(view.size() == 2);
+	assert(view[0].getName() == "def" && view[1].getName() == "gsd");
+
+	// the view reads the live dogs
+	std::vector<std::string> names;
+	for (const Dog& dog : view)
+		names.push_back(dog.getName());
+	assert(names == std::vector<std::string>({ "def", "gsd" }));
+	assert(&view[1] == &repo[2]);
+
+	// other changes of the repository leave it valid
+	repo.add(Dog{ "aaa", "pug", 1, "http4" }, 0);
+	serv.update("gsd", "pug", "xyz", "pug", 6, "http5");
+	assert(view.size() == 2 && view[1].getName() == "xyz");
+	assert(view.indexOf(Dog{ "xyz", "pug", 6, "http5" }) == 1);
+	assert(view.indexOf(Dog{ "aaa", "pug", 1, "http4" }) == -1);
+
+	// dogs leave and come back without the repository changing
+	Dog first = view[0];
+	view.remove(first);
+	assert(view.size() == 1 && repo.size() == 4);
+	view.insert(first, 0);
+	assert(view[0].getName() == "def");
+	view.removeAt(5, Dog{ "xyz", "pug", 6, "http5" });
+	assert(view.size() == 1);
+
+	DogView all{ repo };
+	assert(all.size() == 4 && all[0].getName() == "aaa");
+	assert(serv.filterByString("Y", true).size() == 1);
+
+	delete adoptionList;
+}
+
 /// <summary>
 /// Tests the comparator class
 /// </summary>
@@ -242,7 +1562,7 @@ void Test::testComparator()
 	repo.add(dog5);
 
 	Comparator<Dog>* comp1 = new ComparatorAscendingByName;
-	genericSort<Dog>(repo.getDogs(), comp1);
+	repo.sort(comp1);
 
 	assert(repo[0].getName() == "a");
 	assert(repo[1].getName() == "b");
@@ -252,7 +1572,7 @@ void Test::testComparator()
 	delete comp1;
 
 	Comparator<Dog>* comp2 = new ComparatorDescendingByAge;
-	genericSort<Dog>(repo.getDogs(), comp2);
+	repo.sort(comp2);
 
 	assert(repo[0].getAge() == 5);
 	assert(repo[1].getAge() == 4);
@@ -270,6 +1590,26 @@ void Test::runAllTests()
 	testDomain();
 	testRepo();
 	testServ();
+	testBatch();
+	testJournal();
+	testSnapshot();
+	testFilter();
+	testSearch();
+	testObserver();
+	testImageCache();
+	testLRUCache();
+	testFetchScheduler();
+	testPrefetcher();
+	testFrameStats();
+	testAdoptionExport();
+	testHTMLReport();
+	testPersistenceWorker();
+	testFileUtils();
+	testHistory();
+	testUndoSteps();
+	testDogIds();
+	testCommandDispatcher();
+	testDogView();
 
 	testComparator();
 }
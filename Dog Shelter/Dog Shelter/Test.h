@@ -6,6 +6,26 @@ private:
 	void testDomain();
 	void testRepo();
 	void testServ();
+	void testBatch();
+	void testJournal();
+	void testSnapshot();
+	void testFilter();
+	void testSearch();
+	void testObserver();
+	void testImageCache();
+	void testLRUCache();
+	void testFetchScheduler();
+	void testPrefetcher();
+	void testFrameStats();
+	void testAdoptionExport();
+	void testHTMLReport();
+	void testPersistenceWorker();
+	void testFileUtils();
+	void testHistory();
+	void testUndoSteps();
+	void testDogIds();
+	void testCommandDispatcher();
+	void testDogView();
 	
 	void testComparator();
 
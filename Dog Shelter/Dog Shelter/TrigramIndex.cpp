@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include "TrigramIndex.h"
+
+/// <summary>
+/// Appends the lowercase trigrams of a text
+/// </summary>
+/// <param name="text">the text</param>
+/// <param name="trigrams">receives the trigrams, packed in 24 bits</param>
+void TrigramIndex::addTrigrams(std::string_view text, std::vector<uint32_t>& trigrams)
+{
+	for (size_t i = 0; i + 3 <= text.size(); i++)
+	{
+		uint32_t trigram = 0;
+		for (size_t j = i; j < i + 3; j++)
+			trigram = (trigram << 8) | static_cast<uint32_t>(std::tolower(static_cast<unsigned char>(text[j])));
+
+		trigrams.push_back(trigram);
+	}
+}
+
+/// <summary>
+/// Computes the distinct trigrams of the name and breed of a dog
+/// </summary>
+/// <param name="dog">the dog</param>
+/// <returns>the sorted trigrams</returns>
+std::vector<uint32_t> TrigramIndex::trigramsOf(const Dog& dog)
+{
+	std::vector<uint32_t> trigrams;
+	addTrigrams(dog.getName(), trigrams);
+	addTrigrams(dog.getBreed(), trigrams);
+
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+	return trigrams;
+}
+
+/// <summary>
+/// Adds an entry to the posting lists of its trigrams
+/// </summary>
+/// <param name="id">the id of the entry</param>
+/// <param name="dog">the dog of the entry</param>
+void TrigramIndex::link(const uint32_t& id, const Dog& dog)
+{
+	for (const uint32_t& trigram : trigramsOf(dog))
+	{
+		std::vector<uint32_t>& list = this->postings[trigram];
+
+		// ids are mostly handed out in increasing order
+		if (list.empty() || list.back() < id)
+			list.push_back(id);
+		else
+			list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+	}
+}
+
+/// <summary>
+/// Removes an entry from the posting lists of its trigrams
+/// </summary>
+/// <param name="id">the id of the entry</param>
+/// <param name="dog">the dog of the entry</param>
+void TrigramIndex::unlink(const uint32_t& id, const Dog& dog)
+{
+	for (const uint32_t& trigram : trigramsOf(dog))
+	{
+		auto it = this->postings.find(trigram);
+		if (it == this->postings.end())
+			continue;
+
+		std::vector<uint32_t>& list = it->second;
+		auto position = std::lower_bound(list.begin(), list.end(), id);
+		if (position != list.end() && *position == id)
+			list.erase(position);
+
+		if (list.empty())
+			this->postings.erase(it);
+	}
+}
+
+/// <summary>
+/// Refreshes the positions of the entries that moved
+/// </summary>
+/// <param name="from">the first position that moved</param>
+void TrigramIndex::renumber(const int& from)
+{
+	for (int i = from; i < static_cast<int>(this->ids.size()); i++)
+		this->positions[this->ids[i]] = i;
+}
+
+/// <summary>
+/// Indexes every dog
+/// </summary>
+/// <param name="dogs">the dogs, in repository order</param>
+void TrigramIndex::build(const std::vector<Dog>& dogs)
+{
+	this->reset();
+	this->built = true;
+
+	this->ids.resize(dogs.size());
+	this->positions.resize(dogs.size());
+
+	for (size_t i = 0; i < dogs.size(); i++)
+	{
+		this->ids[i] = static_cast<uint32_t>(i);
+		this->positions[i] = static_cast<int>(i);
+		this->link(static_cast<uint32_t>(i), dogs[i]);
+	}
+}
+
+/// <summary>
+/// Drops the index, it has to be built again before use
+/// </summary>
+void TrigramIndex::reset()
+{
+	this->built = false;
+	this->postings.clear();
+	this->ids.clear();
+	this->positions.clear();
+	this->freeIds.clear();
+}
+
+/// <summary>
+/// Indexes a dog inserted at a position
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="dog">the dog</param>
+void TrigramIndex::insert(const int& index, const Dog& dog)
+{
+	if (!this->built) return;
+
+	uint32_t id;
+	if (this->freeIds.empty())
+	{
+		id = static_cast<uint32_t>(this->positions.size());
+		this->positions.push_back(index);
+	}
+	else
+	{
+		id = this->freeIds.back();
+		this->freeIds.pop_back();
+	}
+
+	this->ids.insert(this->ids.begin() + index, id);
+	this->renumber(index);
+	this->link(id, dog);
+}
+
+/// <summary>
+/// Removes the dog at a position from the index
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="dog">the dog</param>
+void TrigramIndex::erase(const int& index, const Dog& dog)
+{
+	if (!this->built) return;
+
+	uint32_t id = this->ids[index];
+	this->unlink(id, dog);
+
+	this->positions[id] = -1;
+	this->freeIds.push_back(id);
+
+	this->ids.erase(this->ids.begin() + index);
+	this->renumber(index);
+}
+
+/// <summary>
+/// Reindexes the dog at a position after it changed
+/// </summary>
+/// <param name="index">the position of the dog</param>
+/// <param name="oldDog">the previous dog</param>
+/// <param name="newDog">the new dog</param>
+void TrigramIndex::assign(const int& index, const Dog& oldDog, const Dog& newDog)
+{
+	if (!this->built) return;
+
+	uint32_t id = this->ids[index];
+	this->unlink(id, oldDog);
+	this->link(id, newDog);
+}
+
+/// <summary>
+/// Finds the dogs that may contain a text in their name or breed
+/// by intersecting the posting lists of the trigrams of the text
+/// </summary>
+/// <param name="text">the text to look for</param>
+/// <param name="result">receives the sorted positions of the candidates</param>
+/// <returns>true if the index narrowed the search,
+///			 false if the text is too short and every dog is a candidate</returns>
+bool TrigramIndex::candidates(const std::string& text, std::vector<int>& result) const
+{
+	result.clear();
+	if (text.size() < 3)
+		return false;
+
+	std::vector<uint32_t> trigrams;
+	addTrigrams(text, trigrams);
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+	std::vector<const std::vector<uint32_t>*> lists;
+	for (const uint32_t& trigram : trigrams)
+	{
+		auto it = this->postings.find(trigram);
+		if (it == this->postings.end())
+			return true;
+
+		lists.push_back(&it->second);
+	}
+
+	// intersect starting from the rarest trigram
+	std::sort(lists.begin(), lists.end(), [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) { return a->size() < b->size(); });
+
+	std::vector<uint32_t> matches = *lists[0];
+	std::vector<uint32_t> next;
+	for (size_t i = 1; i < lists.size() && !matches.empty(); i++)
+	{
+		next.clear();
+		std::set_intersection(matches.begin(), matches.end(), lists[i]->begin(), lists[i]->end(), std::back_inserter(next));
+		matches.swap(next);
+	}
+
+	result.reserve(matches.size());
+	for (const uint32_t& id : matches)
+		result.push_back(this->positions[id]);
+
+	std::sort(result.begin(), result.end());
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <unordered_map>
+#include "Dog.h"
+
+// Inverted index from the lowercase trigrams of the names and breeds
+// to the dogs containing them, used to narrow down substring searches.
+// Entries get internal ids so that moving a dog only renumbers the
+// id to position map instead of every posting list.
+class TrigramIndex
+{
+private:
+	bool built = false;
+
+	// trigram -> sorted ids of the entries containing it
+	std::unordered_map<uint32_t, std::vector<uint32_t>> postings;
+	// position -> id and id -> position
+	std::vector<uint32_t> ids;
+	std::vector<int> positions;
+	std::vector<uint32_t> freeIds;
+
+	static std::vector<uint32_t> trigramsOf(const Dog& dog);
+	static void addTrigrams(std::string_view text, std::vector<uint32_t>& trigrams);
+
+	void link(const uint32_t& id, const Dog& dog);
+	void unlink(const uint32_t& id, const Dog& dog);
+	void renumber(const int& from);
+
+public:
+	bool isBuilt() const { return this->built; }
+
+	void build(const std::vector<Dog>& dogs);
+	void reset();
+
+	void insert(const int& index, const Dog& dog);
+	void erase(const int& index, const Dog& dog);
+	void assign(const int& index, const Dog& oldDog, const Dog& newDog);
+
+	bool candidates(const std::string& text, std::vector<int>& result) const;
+};
@@ -1,32 +1,29 @@
 #include <QtWidgets/QApplication>
 #include <QScreen>
-#include <QtNetwork/QNetworkReply>
 #include <QEventLoop>
 #include <QMessageBox>
 #include <QHBoxLayout>
 #include <QFormLayout>
 #include <QHeaderView>
+#include <QScrollBar>
 #include "UserGUI.h"
+#include "Config.h"
 
-UserGUI::UserGUI(Service& serv, QWidget* modeSelector, QWidget* parent) : QWidget{ parent }, modeSelector{ modeSelector }, serv{ serv }
+UserGUI::UserGUI(Service& serv, QWidget* modeSelector, QWidget* parent) : QWidget{ parent }, modeSelector{ modeSelector }, serv{ serv },
+	history{ ActionContext{ serv.getRepo(), &this->dogsToShow, serv.getAdoptionList() }, "Adoptions.history", Config::getHistoryEntries(), Config::getHistoryBytes() },
+	prefetcher{ Config::getPrefetchCount() }
 {
-	this->networkManager = new QNetworkAccessManager{ this };
-	this->images = new std::unordered_map<QString, QPixmap>();
+	this->imageLoader = new ImageLoader{ Config::getPixmapCacheBytes(), this };
 
 	this->adopted = this->serv.getAdoptionList();
-	this->tableModel = new AdoptionTableModel{ this->adopted };
-	this->pictureDelegate = new PictureDelegate{ this->tableModel, this->images };
+	this->tableModel = new AdoptionTableModel{ this->adopted, this };
+	this->pictureDelegate = new PictureDelegate{ this->tableModel, this->imageLoader, this };
 
 	this->initGUI();
 	this->center();
 	this->connectSignalsAndSlots();
 }
 
-UserGUI::~UserGUI()
-{
-	delete this->images;
-}
-
 void UserGUI::initGUI()
 {	
 	QFont font{ "Arial", 14 };
@@ -165,6 +162,7 @@ void UserGUI::initGUI()
 
 	// set the custom delegate
 	this->picturesTableView->setItemDelegate(this->pictureDelegate);
+	this->pictureDelegate->measure(this->picturesTableView->viewport());
 
 	// hide the vertical header
 	this->picturesTableView->verticalHeader()->hide();
@@ -196,7 +194,10 @@ void UserGUI::center()
 
 void UserGUI::connectSignalsAndSlots()
 {
-	QObject::connect(this->networkManager, &QNetworkAccessManager::finished, this, &UserGUI::receivedReply);
+	QObject::connect(this->imageLoader, &ImageLoader::imageLoaded, this, &UserGUI::imageLoaded);
+
+	// drop the downloads of the rows scrolled out of view
+	QObject::connect(this->picturesTableView->verticalScrollBar(), &QScrollBar::valueChanged, this, &UserGUI::updateVisiblePhotographs);
 
 	// add button connections
 	QObject::connect(this->viewAllButton, &QPushButton::clicked, this, &UserGUI::viewAllDogs);
@@ -239,7 +240,7 @@ void UserGUI::showError(const std::string& err)
 
 void UserGUI::loadCurrentDog()
 {
-	Dog dog = this->dogsToShow[this->currentIndex];
+	const Dog& dog = this->dogsToShow[this->currentIndex];
 
 	this->dogNameEdit->setText(QString::fromStdString(dog.getName()));
 	this->dogBreedEdit->setText(QString::fromStdString(dog.getBreed()));
@@ -247,34 +248,46 @@ void UserGUI::loadCurrentDog()
 
 	QString photograph = QString::fromStdString(dog.getPhotohraph());
 
-	if (this->images->find(photograph) != this->images->end())
-	{
-		QPixmap pixmap = this->images->at(photograph);
-
-		QImage image{ pixmap.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied) };
-		image = image.scaled(IMAGE_WIDTH, IMAGE_HEIGHT, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::TransformationMode::SmoothTransformation);
-		image = image.copy((image.width() - IMAGE_WIDTH) / 2, (image.height() - IMAGE_HEIGHT) / 2, IMAGE_WIDTH, IMAGE_HEIGHT);
-
-		this->dogImage->setPixmap(QPixmap::fromImage(image));
-	}
+	// the loader hands out the photograph already scaled and cropped
+	const QPixmap* pixmap = this->imageLoader->find(photograph, QSize{ IMAGE_WIDTH, IMAGE_HEIGHT }, ImageFit::Crop, this->dogImage->devicePixelRatioF());
+	this->prefetcher.shown(dog.getPhotohraph(), pixmap != nullptr);
+	if (pixmap != nullptr)
+		this->dogImage->setPixmap(*pixmap);
 	else
-	{
-		this->loadImage(photograph);
-	}
+		this->imageLoader->request(photograph, QSize{ IMAGE_WIDTH, IMAGE_HEIGHT }, ImageFit::Crop, FetchPriority::Foreground,
+			this->dogImage->devicePixelRatioF());
+
+	this->prefetchNextDogs();
 
 	//std::string command = "start ";
 	//system(command.append(dog.getPhotohraph()).c_str());
 }
 
-void UserGUI::loadImage(const QString& imageURL)
+void UserGUI::prefetchNextDogs()
 {
-	QUrl url{ imageURL };
-	this->networkManager->get(QNetworkRequest(url));
+	std::vector<QString> urls;
+	for (const int& index : this->prefetcher.next(this->currentIndex, this->dogsToShow.size()))
+	{
+		const std::string& photograph = this->dogsToShow[index].getPhotohraph();
+		urls.push_back(QString::fromStdString(photograph));
+
+		// a photograph already on hand is not counted as prefetched, the
+		// check leaves the recency and the hit counts of the cache alone
+		QString thumbnailKey = ImageLoader::thumbnailKey(urls.back(), QSize{ IMAGE_WIDTH, IMAGE_HEIGHT }, ImageFit::Crop, this->dogImage->devicePixelRatioF());
+		if (this->imageLoader->getMemoryCache().peek(thumbnailKey) != nullptr)
+			continue;
+
+		this->prefetcher.prefetch(photograph);
+		this->imageLoader->request(urls.back(), QSize{ IMAGE_WIDTH, IMAGE_HEIGHT }, ImageFit::Crop, FetchPriority::Prefetch,
+			this->dogImage->devicePixelRatioF());
+	}
+
+	this->imageLoader->retain(urls, FetchPriority::Prefetch);
 }
 
 void UserGUI::viewAllDogs()
 {
-	this->dogsToShow = this->serv.getRepo();
+	this->dogsToShow = DogView{ this->serv.getRepo() };
 	emit prepareAdoptionSignal();
 }
 
@@ -312,12 +325,11 @@ void UserGUI::adoptButtonHandler()
 
 	std::unique_ptr<Action> p = std::make_unique<ActionAdopt>(
 		dog, this->serv.getRepo(), this->serv.getRepo().indexOf(dog),
-		this->dogsToShow, this->dogsToShow.indexOf(dog),
+		this->dogsToShow, this->currentIndex,
 		this->serv.getAdoptionList(), this->serv.getAdoptionList()->size() + 1);
-	undoStack.push_back(std::move(p));
-	redoStack.clear();
+	this->history.record(std::move(p));
 
-	this->dogsToShow.remove(dog);
+	this->dogsToShow.removeAt(this->currentIndex, dog);
 
 	emit adoptSignal(dog);
 	this->currentIndex--;
@@ -345,7 +357,10 @@ void UserGUI::loadNextDog()
 void UserGUI::stopShowingDogs()
 {
 	this->currentIndex = -1;
-	this->dogsToShow.getDogs().clear();
+	this->dogsToShow.clear();
+
+	this->imageLoader->retain({}, FetchPriority::Prefetch);
+	this->prefetcher.reset();
 
 	QPixmap pixmap{};
 	pixmap.fill(Qt::white);
@@ -378,12 +393,10 @@ void UserGUI::undo()
 {
 	try
 	{
-		if (undoStack.size() == 0)
+		std::unique_ptr<Action> action = this->history.takeUndo();
+		if (action == nullptr)
 			throw UndoException("There is nothing to undo!");
 
-		std::unique_ptr<Action> action = std::move(undoStack.back());
-		undoStack.pop_back();
-
 		{
 			Action* tempBase = action.get();
 			ActionAdopt* tempDerived = static_cast<ActionAdopt*>(tempBase);
@@ -393,7 +406,7 @@ void UserGUI::undo()
 		}
 
 		action.get()->executeUndo();
-		redoStack.push_back(std::move(action));
+		this->history.pushRedo(std::move(action));
 
 		emit updateTableSignal();
 		this->showInformation("The last operation was undone successfully.");
@@ -408,17 +421,15 @@ void UserGUI::redo()
 {
 	try
 	{
-		if (redoStack.size() == 0)
+		std::unique_ptr<Action> action = this->history.takeRedo();
+		if (action == nullptr)
 			throw RedoException("There is nothing to redo!");
 
-		std::unique_ptr<Action> action = std::move(redoStack.back());
-		redoStack.pop_back();
-
 		{
 			Action* tempBase = action.get();
 			ActionAdopt* tempDerived = static_cast<ActionAdopt*>(tempBase);
 
-			if (this->currentIndex != -1 && tempDerived->getDog() == dogsToShow[this->currentIndex])
+			if (this->currentIndex != -1 && tempDerived->getDog().getId() == this->dogsToShow.idAt(this->currentIndex))
 				emit nextDogSignal();
 			
 			if (this->currentIndex >= tempDerived->getDogsToShowIndex())
@@ -426,7 +437,7 @@ void UserGUI::redo()
 		}
 
 		action.get()->executeRedo();
-		undoStack.push_back(std::move(action));
+		this->history.pushUndo(std::move(action));
 
 		emit updateTableSignal();
 		this->showInformation("The last operation was redone successfully.");
@@ -439,8 +450,7 @@ void UserGUI::redo()
 
 void UserGUI::clearUndoRedo()
 {
-	undoStack.clear();
-	redoStack.clear();
+	this->history.clear();
 }
 
 void UserGUI::prepareAdoption()
@@ -451,8 +461,6 @@ void UserGUI::prepareAdoption()
 		return;
 	}
 
-	this->dogsToShow.setFileName("");
-
 	this->dogBreedEdit->setEnabled(false);
 	this->dogAgeEdit->setEnabled(false);
 
@@ -492,35 +500,38 @@ void UserGUI::adopt(const Dog& dog)
 
 void UserGUI::updateTable()
 {
-	emit this->tableModel->layoutChanged();
+	// the model already emitted the changed rows, only the sizes are refreshed
 	// force the columns to resize, according to the size of their contents
 	this->picturesTableView->resizeColumnsToContents();
 	this->picturesTableView->resizeRowsToContents();
 }
 
-void UserGUI::receivedReply(QNetworkReply* reply)
+void UserGUI::updateVisiblePhotographs()
 {
-	QPixmap pixmap{};
-	pixmap.fill(Qt::black);
+	int first = this->picturesTableView->rowAt(0);
+	int last = this->picturesTableView->rowAt(this->picturesTableView->viewport()->height() - 1);
+	if (first == -1)
+		return;
+	if (last == -1)
+		last = this->adopted->size() - 1;
 
-	if (reply->error() == QNetworkReply::NoError)
-	{
-		QByteArray replyData = reply->readAll();
-		pixmap.loadFromData(replyData);
+	std::vector<QString> urls;
+	for (int row = first; row <= last; row++)
+		urls.push_back(QString::fromStdString((*this->adopted)[row].getPhotohraph()));
 
-		if (pixmap.isNull())
-		{
-			pixmap = QPixmap{};
-			pixmap.fill(Qt::black);
-		}
-	}
+	this->imageLoader->retain(urls, FetchPriority::Visible);
+}
 
-	this->images->operator[](reply->url().toString()) = pixmap;
-	
-	QImage image{ pixmap.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied) };
-	image = image.scaled(IMAGE_WIDTH, IMAGE_HEIGHT, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::TransformationMode::SmoothTransformation);
-	image = image.copy((image.width() - IMAGE_WIDTH) / 2, (image.height() - IMAGE_HEIGHT) / 2, IMAGE_WIDTH, IMAGE_HEIGHT);
+void UserGUI::imageLoaded(const QString& url)
+{
+	// only the image of the dog on screen is shown
+	if (this->currentIndex < 0 || this->currentIndex >= this->dogsToShow.size())
+		return;
+
+	if (QString::fromStdString(this->dogsToShow[this->currentIndex].getPhotohraph()) != url)
+		return;
 
-	this->dogImage->setPixmap(QPixmap::fromImage(image));
-	reply->deleteLater();
+	const QPixmap* pixmap = this->imageLoader->find(url, QSize{ IMAGE_WIDTH, IMAGE_HEIGHT }, ImageFit::Crop, this->dogImage->devicePixelRatioF());
+	if (pixmap != nullptr)
+		this->dogImage->setPixmap(*pixmap);
 }
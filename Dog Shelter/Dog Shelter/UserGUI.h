@@ -1,19 +1,20 @@
 #pragma once
 
 #include <qwidget.h>
-#include <QtNetwork/QNetworkAccessManager>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QTabWidget>
 #include <QTableView>
 #include <QShortcut>
-#include <unordered_map>
 #include "AdoptionTableModel.h"
 #include "PictureDelegate.h"
+#include "ImageLoader.h"
+#include "Prefetcher.h"
 #include "Service.h"
 #include "AdoptionList.h"
 #include "Action.h"
+#include "History.h"
 #include "Dog.h"
 
 #define IMAGE_WIDTH 320
@@ -25,19 +26,21 @@ class UserGUI : public QWidget
 
 public:
 	UserGUI(Service& serv, QWidget* modeSelector, QWidget* parent = Q_NULLPTR);
-	~UserGUI();
+	~UserGUI() = default;
+
+	// the prefetch hit rates, to tune the look-ahead
+	const Prefetcher& getPrefetcher() const { return this->prefetcher; }
 
 private:
 	Service& serv;
 	QWidget* modeSelector;
-	QNetworkAccessManager* networkManager;
-	std::unordered_map<QString, QPixmap>* images;
+	ImageLoader* imageLoader;
 
-	std::vector<std::unique_ptr<Action>> undoStack;
-	std::vector<std::unique_ptr<Action>> redoStack;
+	History history;
 
-	Repository dogsToShow;
+	DogView dogsToShow;
 	int currentIndex = -1;
+	Prefetcher prefetcher;
 	AdoptionList* adopted;
 	
 	QTabWidget* tabWidget;
@@ -73,7 +76,8 @@ private:
 	void adoptButtonHandler();
 
 	void loadCurrentDog();
-	void loadImage(const QString& imageURL);
+	void prefetchNextDogs();
+	void updateVisiblePhotographs();
 
 signals:
 	void prepareAdoptionSignal();
@@ -86,7 +90,7 @@ signals:
 	void clearAdminUndoRedoSignal();
 
 public slots:
-	void receivedReply(QNetworkReply* reply);
+	void imageLoaded(const QString& url);
 	
 	void viewAllDogs();
 	void viewFilteredDogs();
@@ -1,4 +1,6 @@
 #include <sstream>
+#include <algorithm>
+#include <cctype>
 #include "Utils.h"
 
 /// <summary>
@@ -18,3 +20,101 @@ std::vector<std::string> tokenize(std::string data, char delimiter)
 
 	return result;
 }
+
+/// <summary>
+/// Splits a line into an exact number of fields without copying it
+/// </summary>
+/// <param name="line">the line to split</param>
+/// <param name="delimiter">the delimiter between the fields</param>
+/// <param name="fields">receives a view of each field</param>
+/// <param name="count">the expected number of fields</param>
+/// <returns>true if the line has exactly count fields,
+///			 false, otherwise</returns>
+bool splitFields(std::string_view line, char delimiter, std::string_view* fields, const int& count)
+{
+	for (int i = 0; i < count - 1; i++)
+	{
+		size_t position = line.find(delimiter);
+		if (position == std::string_view::npos)
+			return false;
+
+		fields[i] = line.substr(0, position);
+		line.remove_prefix(position + 1);
+	}
+
+	if (line.find(delimiter) != std::string_view::npos)
+		return false;
+
+	fields[count - 1] = line;
+	return true;
+}
+
+/// <summary>
+/// Computes the CRC-32 (IEEE 802.3) checksum of a buffer,
+/// eight bytes are folded per step (slicing-by-8)
+/// </summary>
+/// <param name="data">the buffer</param>
+/// <returns>the checksum</returns>
+uint32_t crc32(std::string_view data)
+{
+	static const std::vector<std::vector<uint32_t>> tables = []()
+	{
+		std::vector<std::vector<uint32_t>> values(8, std::vector<uint32_t>(256));
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t value = i;
+			for (int bit = 0; bit < 8; bit++)
+				value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+
+			values[0][i] = value;
+		}
+
+		for (uint32_t i = 0; i < 256; i++)
+			for (int slice = 1; slice < 8; slice++)
+				values[slice][i] = (values[slice - 1][i] >> 8) ^ values[0][values[slice - 1][i] & 0xFF];
+
+		return values;
+	}();
+
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data());
+	size_t length = data.size();
+	uint32_t crc = 0xFFFFFFFFu;
+
+	while (length >= 8)
+	{
+		uint32_t low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+		uint32_t high = bytes[4] | bytes[5] << 8 | bytes[6] << 16 | static_cast<uint32_t>(bytes[7]) << 24;
+
+		crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+			tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+
+		bytes += 8;
+		length -= 8;
+	}
+
+	while (length-- > 0)
+		crc = tables[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+
+	return crc ^ 0xFFFFFFFFu;
+}
+
+/// <summary>
+/// Checks whether a text contains a pattern
+/// </summary>
+/// <param name="text">the text to search in</param>
+/// <param name="pattern">the pattern to look for</param>
+/// <param name="ignoreCase">true to compare ASCII letters case insensitively</param>
+/// <returns>true if the pattern occurs in the text,
+///			 false, otherwise</returns>
+bool contains(std::string_view text, std::string_view pattern, const bool& ignoreCase)
+{
+	if (!ignoreCase)
+		return text.find(pattern) != std::string_view::npos;
+
+	auto match = std::search(text.begin(), text.end(), pattern.begin(), pattern.end(), [](const char& a, const char& b)
+		{
+			return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+		});
+
+	return match != text.end() || pattern.empty();
+}
@@ -2,5 +2,37 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
 
 std::vector<std::string> tokenize(std::string data, char delimiter);
+bool splitFields(std::string_view line, char delimiter, std::string_view* fields, const int& count);
+uint32_t crc32(std::string_view data);
+bool contains(std::string_view text, std::string_view pattern, const bool& ignoreCase);
+
+/// <summary>
+/// Calls a function for every line of a buffer without copying it,
+/// the newlines are found with memchr which the C library vectorizes
+/// </summary>
+/// <param name="data">the buffer to scan</param>
+/// <param name="callback">called with a view of each line, without the line ending</param>
+template <typename F>
+void forEachLine(std::string_view data, F callback)
+{
+	const char* begin = data.data();
+	const char* end = begin + data.size();
+
+	while (begin < end)
+	{
+		const char* newline = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+		const char* lineEnd = newline == nullptr ? end : newline;
+
+		std::string_view line{ begin, static_cast<size_t>(lineEnd - begin) };
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		callback(line);
+		begin = lineEnd + 1;
+	}
+}
@@ -1,10 +1,12 @@
 #include <QtWidgets/QApplication>
 #include "RepoTypeSelector.h"
+#include "Config.h"
 
 int main(int argc, char* argv[])
 {
 	QApplication a(argc, argv);
 	QGuiApplication::setApplicationDisplayName("Dog Shelter");
+	Config::parse(argc, argv);
 
 	std::unique_ptr<RepoTypeSelector> repoTypeSelector = std::make_unique<RepoTypeSelector>();
 	repoTypeSelector.get()->show();